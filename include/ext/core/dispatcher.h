@@ -22,8 +22,10 @@ Example of recipient:
         void Event(int val) override { std::cout << "Event"; }
     }
 */
+#include <atomic>
 #include <exception>
 #include <functional>
+#include <future>
 #include <list>
 #include <map>
 #include <shared_mutex>
@@ -41,7 +43,8 @@ Example of recipient:
 #include <ext/scope/defer.h>
 
 #include <ext/thread/invoker.h>
-#include <ext/thread/thread_pool.h>
+#include <ext/thread/runtime.h>
+#include <ext/thread/serial_lane.h>
 
 #include <ext/types/utils.h>
 
@@ -66,6 +69,8 @@ void send_event(Function IEvent::* function, Args&&... eventArgs) EXT_THROWS(...
     Note: Code will be executed in a different thread, be aware about arguments synchronization
     Note: If ext::events::event_handled exception was raised during an event handling it will stop iterating over recipients.
     Note: If any other unhandled exceptions was raised during event processing it will store it in the returned future
+    Note: Events which are not sent till the program exit are discarded, their futures store std::future_error
+          with std::future_errc::broken_promise
 
     Example:
         ext::send_event_async(&IEvent::Event, 10);
@@ -135,6 +140,11 @@ private:
 
     std::map<EventId, EventRecipients> m_eventRecipients;
     mutable std::shared_mutex m_recipientsMutex;
+
+    // lane sending async events one by one, common for all events to keep the order of sending between them
+    static ext::serial_lane& GetAsyncEventsLane();
+    // set at the program exit, not sent async events are discarded
+    inline static std::atomic_bool m_asyncEventsDiscarded = false;
 };
 
 // Scope subscription manager
@@ -263,11 +273,26 @@ std::future<void> Dispatcher::SendEventAsync(Function IEvent::* function, Args&&
     };
 
     ext::ThreadInvoker invoker(std::move(functionToInvoke), function, std::forward<Args>(eventArgs)...);
-    
-    static thread_pool thread_pool(1);
-    return thread_pool.add_task([invoker = std::move(invoker)]() mutable { 
+    return GetAsyncEventsLane().add_task([invoker = std::move(invoker)]() mutable {
+            if (m_asyncEventsDiscarded)
+                throw std::future_error(std::future_errc::broken_promise);
             invoker();
-        }).second;
+        });
+}
+
+inline ext::serial_lane& Dispatcher::GetAsyncEventsLane()
+{
+    // recipients might block so the lane uses the global runtime blocking pool to not occupy CPU pool workers
+    static ext::serial_lane eventsLane(ext::runtime::GlobalInstance().blocking_pool());
+
+    // blocking pool executes the queued lane tasks on its destruction at the program exit, discarder is
+    // destroyed before the runtime so not sent events are discarded instead of sending them during the exit
+    static const struct EventsDiscarder
+    {
+        ~EventsDiscarder() { m_asyncEventsDiscarded = true; }
+    } eventsDiscarder;
+
+    return eventsLane;
 }
 
 template <typename IEvent>
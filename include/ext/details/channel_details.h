@@ -0,0 +1,212 @@
+#pragma once
+
+/*
+ * Common parts of the channels implementations
+ */
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include <ext/core/defines.h>
+
+namespace ext::channel_details {
+
+// size of the cache line, indices changed by different threads are placed on different lines
+constexpr std::size_t kCacheLineSize = 64;
+
+// count of ext::thread_details::exponential_wait steps before parking on the empty or full channel
+constexpr std::uint32_t kSpinSteps = 8;
+
+// wait node of the ext::select call, registered in all channels of the select and notified on their state changes
+struct select_waiter {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool signaled = false;
+
+    void notify() noexcept {
+        std::lock_guard<std::mutex> lock(mutex);
+        signaled = true;
+        cv.notify_one();
+    }
+};
+
+// access of ext::select to the channel internals, defined in ext/thread/select.h
+struct select_access;
+
+// FIFO queue of linked fixed size segments, drained segments are kept in the free list and reused,
+// so the steady traffic and repeated bursts don't allocate memory. Free list keeps at most kMaxFreeSegments,
+// the rest of the drained segments are deleted, so the queue doesn't keep the memory of the largest burst
+template <typename T>
+class segmented_queue {
+public:
+    // count of elements in one segment, segments of the small elements take about 512 bytes
+    static constexpr std::size_t kSegmentSize = sizeof(T) < 32 ? 512 / sizeof(T) : 16;
+    // max count of the drained segments kept for reuse
+    static constexpr std::size_t kMaxFreeSegments = 4;
+
+    segmented_queue() = default;
+    segmented_queue(const segmented_queue&) = delete;
+    segmented_queue& operator=(const segmented_queue&) = delete;
+
+    ~segmented_queue() {
+        clear();
+        delete m_head;
+        while (m_free != nullptr) {
+            delete std::exchange(m_free, m_free->next);
+        }
+    }
+
+    [[nodiscard]] bool empty() const noexcept { return m_size == 0; }
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    [[nodiscard]] T& front() noexcept { return *m_head->element(m_head_index); }
+
+    template <typename ...Args>
+    void emplace(Args&& ...args) {
+        segment* target = m_tail;
+        std::size_t index = m_tail_index;
+        if (target == nullptr || index == kSegmentSize) {
+            target = acquire_segment();
+            index = 0;
+        }
+        try {
+            ::new (static_cast<void*>(target->storage + index * sizeof(T))) T(std::forward<Args>(args)...);
+        } catch (...) {
+            if (target != m_tail) {
+                release_segment(target);
+            }
+            throw;
+        }
+
+        if (target != m_tail) {
+            if (m_tail == nullptr) {
+                m_head = target;
+                m_head_index = 0;
+            } else {
+                m_tail->next = target;
+            }
+            m_tail = target;
+        }
+        m_tail_index = index + 1;
+        ++m_size;
+    }
+
+    void pop() noexcept {
+        m_head->element(m_head_index)->~T();
+        ++m_head_index;
+        --m_size;
+        if (m_head == m_tail) {
+            // last segment is reused from the beginning when it becomes empty
+            if (m_size == 0) {
+                m_head_index = m_tail_index = 0;
+            }
+        } else if (m_head_index == kSegmentSize) {
+            release_segment(std::exchange(m_head, m_head->next));
+            m_head_index = 0;
+        }
+    }
+
+    void clear() noexcept {
+        while (!empty()) {
+            pop();
+        }
+    }
+
+private:
+    struct segment {
+        alignas(T) std::byte storage[sizeof(T) * kSegmentSize];
+        segment* next = nullptr;
+
+        [[nodiscard]] T* element(std::size_t index) noexcept {
+            return std::launder(reinterpret_cast<T*>(storage + index * sizeof(T)));
+        }
+    };
+
+    [[nodiscard]] segment* acquire_segment() {
+        if (m_free == nullptr) {
+            return new segment;
+        }
+        segment* result = std::exchange(m_free, m_free->next);
+        result->next = nullptr;
+        --m_free_count;
+        return result;
+    }
+
+    void release_segment(segment* drained) noexcept {
+        if (m_free_count == kMaxFreeSegments) {
+            delete drained;
+            return;
+        }
+        drained->next = m_free;
+        m_free = drained;
+        ++m_free_count;
+    }
+
+private:
+    segment* m_head = nullptr;
+    std::size_t m_head_index = 0;
+    segment* m_tail = nullptr;
+    std::size_t m_tail_index = 0;
+    std::size_t m_size = 0;
+    // drained segments ready for reuse
+    segment* m_free = nullptr;
+    std::size_t m_free_count = 0;
+};
+
+// range-for iterator of the channel, each increment gets the next channel element till the channel is closed
+template <typename Channel, typename T>
+class channel_iterator {
+public:
+    using value_type = T;
+
+private:
+    Channel* m_channel;
+    std::optional<value_type> m_value;
+
+    constexpr channel_iterator(Channel* channel, std::optional<value_type>&& value = std::nullopt)
+        : m_channel(channel)
+        , m_value(std::move(value))
+    {}
+
+    friend Channel;
+public:
+    channel_iterator(const channel_iterator& other) = delete;
+    constexpr explicit channel_iterator(channel_iterator&& other) noexcept
+        : m_channel(other.m_channel)
+        , m_value(std::move(other.m_value))
+    {
+        other.m_value = std::nullopt;
+    }
+
+    constexpr bool operator==(const channel_iterator& other) const {
+        return m_channel == other.m_channel && !m_value.has_value() && !other.m_value.has_value();
+    }
+
+    constexpr bool operator!=(const channel_iterator& other) const {
+        return !operator==(other);
+    }
+
+    constexpr const value_type& operator*() const { return m_value.value(); }
+
+    constexpr value_type& operator*() { return m_value.value(); }
+
+    constexpr value_type* operator->() { return &m_value.value(); }
+
+    constexpr const value_type* operator->() const { return &m_value.value(); }
+
+    channel_iterator& operator++() EXT_THROWS(std::bad_function_call) {
+        if (!m_value.has_value()) {
+            throw std::bad_function_call();
+        }
+        m_value = m_channel->get();
+        return *this;
+    }
+};
+
+} // namespace ext::channel_details
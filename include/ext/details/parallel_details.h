@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+
+#include <ext/thread/stop_token.h>
+#include <ext/thread/thread.h>
+#include <ext/thread/thread_pool.h>
+
+namespace ext::parallel_details {
+
+// count of chunks which each participant gets in average when the chunk size is selected automatically
+constexpr std::size_t kAutoChunksPerParticipant = 32;
+
+// Loop over [0, size) range split into chunks, chunks are claimed by the calling thread and the pool tasks.
+// Object is shared with tasks, late tasks which start after the loop end just find no chunks to execute
+template <typename Body>
+class chunked_loop
+{
+public:
+    chunked_loop(std::size_t size, std::size_t minChunkSize, std::size_t participantsCount,
+                 const ext::stop_token& stopToken, Body& body) noexcept
+        : m_size(size)
+        , m_minChunkSize(minChunkSize)
+        , m_participantsCount(participantsCount)
+        , m_stopToken(stopToken)
+        , m_body(body)
+    {}
+
+    // claim and execute chunks till the end of the range
+    void execute() noexcept
+    {
+        std::size_t begin, end;
+        while (claim_chunk(begin, end))
+        {
+            try
+            {
+                if (m_stopToken.stop_requested())
+                    throw ext::thread::thread_interrupted();
+                m_body(begin, end);
+            }
+            catch (...)
+            {
+                {
+                    std::lock_guard lock(m_mutex);
+                    if (!m_exception)
+                        m_exception = std::current_exception();
+                }
+
+                // skip not claimed chunks
+                if (const std::size_t notClaimedBegin = m_next.exchange(m_size); notClaimedBegin < m_size)
+                    complete(m_size - notClaimedBegin);
+            }
+            complete(end - begin);
+        }
+    }
+
+    // wait till all chunks are executed or skipped, rethrow the first exception of the chunks execution
+    void wait()
+    {
+        std::unique_lock lock(m_mutex);
+        m_completedCv.wait(lock, [&]() { return m_completedCount == m_size; });
+        if (m_exception)
+            std::rethrow_exception(m_exception);
+    }
+
+private:
+    // guided scheduling, chunks are decreasing with the remaining range to balance the load in the end
+    bool claim_chunk(std::size_t& begin, std::size_t& end) noexcept
+    {
+        begin = m_next.load(std::memory_order_relaxed);
+        std::size_t chunkSize;
+        do
+        {
+            if (begin >= m_size)
+                return false;
+
+            const std::size_t remaining = m_size - begin;
+            chunkSize = std::min(remaining, std::max(m_minChunkSize, remaining / (2 * m_participantsCount)));
+        } while (!m_next.compare_exchange_weak(begin, begin + chunkSize, std::memory_order_relaxed));
+
+        end = begin + chunkSize;
+        return true;
+    }
+
+    void complete(std::size_t count) noexcept
+    {
+        if (m_completedCount.fetch_add(count) + count != m_size)
+            return;
+
+        // waiter might check the counter and go to sleep right now, wait till it releases the mutex
+        { std::lock_guard lock(m_mutex); }
+        m_completedCv.notify_all();
+    }
+
+private:
+    const std::size_t m_size;
+    const std::size_t m_minChunkSize;
+    const std::size_t m_participantsCount;
+    const ext::stop_token m_stopToken;
+    Body& m_body;
+
+    // begin of the first not claimed chunk
+    std::atomic_size_t m_next = 0;
+    // count of executed or skipped elements
+    std::atomic_size_t m_completedCount = 0;
+
+    std::mutex m_mutex;
+    std::condition_variable m_completedCv;
+    std::exception_ptr m_exception;
+};
+
+// count of threads which execute parallel algorithm, calling thread helps to the pool workers
+[[nodiscard]] inline std::size_t participants_count(const ext::thread_pool& threadPool) noexcept
+{
+    return threadPool.threads_count() + 1;
+}
+
+/**
+ * \brief Split [0, size) range into chunks and execute body(begin, end) for them on the pool and the calling thread
+ * \param threadPool pool for chunks execution
+ * \param stopToken if stop is requested - not started chunks are skipped and ext::thread::thread_interrupted is thrown
+ * \param size range size
+ * \param minChunkSize min count of elements in one chunk, 0 - selected automatically
+ * \param body chunk execution function
+ * \throw first exception thrown by body
+ */
+template <typename Body>
+void run_chunks(ext::thread_pool& threadPool, const ext::stop_token& stopToken,
+                std::size_t size, std::size_t minChunkSize, Body&& body)
+{
+    if (size == 0)
+        return;
+
+    const std::size_t participantsCount = participants_count(threadPool);
+    if (minChunkSize == 0)
+        minChunkSize = std::max<std::size_t>(1, size / (participantsCount * kAutoChunksPerParticipant));
+
+    auto loop = std::make_shared<chunked_loop<std::remove_reference_t<Body>>>(
+        size, minChunkSize, participantsCount, stopToken, body);
+
+    // the calling thread takes the first chunk, tasks are needed only for the rest of them
+    if (const std::size_t tasksCount = std::min(threadPool.threads_count(), (size - 1) / minChunkSize); tasksCount != 0)
+        threadPool.add_tasks(ext::thread_pool::IndexRange(tasksCount), [loop](std::size_t) { loop->execute(); });
+
+    loop->execute();
+    loop->wait();
+}
+
+} // namespace ext::parallel_details
@@ -0,0 +1,541 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if __has_include(<bit>)
+#include <bit>
+#endif
+
+#include <ext/core/check.h>
+#include <ext/thread/thread.h>
+#include <ext/thread/wait_group.h>
+
+namespace ext::thread_pool_details {
+
+// Error of the task which deadline passed before the execution start
+class deadline_exceeded : public std::runtime_error
+{
+public:
+    deadline_exceeded() : std::runtime_error("Task deadline exceeded") {}
+};
+
+// Error of adding task to the full queue with the reject overflow policy
+class queue_overflow : public std::runtime_error
+{
+public:
+    queue_overflow() : std::runtime_error("Thread pool queue is full") {}
+};
+
+// Index of the highest set bit, value must not be zero
+[[nodiscard]] inline unsigned highest_bit_index(std::uint64_t value) noexcept
+{
+#if defined(__cpp_lib_bitops)
+    return static_cast<unsigned>(std::bit_width(value)) - 1;
+#else
+    unsigned index = 0;
+    while (value >>= 1)
+    {
+        ++index;
+    }
+    return index;
+#endif
+}
+
+// Move only function wrapper with small buffer optimization, small functions are stored without allocations
+class task_function
+{
+public:
+    // size of the functions which can be stored without allocation
+    static constexpr std::size_t kBufferSize = 56;
+
+    template <typename Function>
+    static constexpr bool is_stored_inplace_v = sizeof(Function) <= kBufferSize &&
+                                                alignof(Function) <= alignof(std::max_align_t) &&
+                                                std::is_nothrow_move_constructible_v<Function>;
+
+    task_function() noexcept = default;
+    task_function(task_function&& other) noexcept { move_from(other); }
+    task_function& operator=(task_function&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            move_from(other);
+        }
+        return *this;
+    }
+    ~task_function() { reset(); }
+
+    task_function(const task_function&) = delete;
+    task_function& operator=(const task_function&) = delete;
+
+    // construct function object inside wrapper, return reference to the created object
+    template <typename Function, typename... Args>
+    Function& emplace(Args&&... args)
+    {
+        reset();
+        Function* function;
+        if constexpr (is_stored_inplace_v<Function>)
+            function = ::new (static_cast<void*>(m_buffer)) Function(std::forward<Args>(args)...);
+        else
+        {
+            function = new Function(std::forward<Args>(args)...);
+            ::new (static_cast<void*>(m_buffer)) Function*(function);
+        }
+        m_operations = &kOperations<Function>;
+        return *function;
+    }
+
+    void operator()()
+    {
+        EXT_ASSERT(m_operations) << "Calling empty function";
+        m_operations->invoke(m_buffer);
+    }
+
+    // destroy stored function
+    void reset() noexcept
+    {
+        if (m_operations)
+        {
+            m_operations->destroy(m_buffer);
+            m_operations = nullptr;
+        }
+    }
+
+    [[nodiscard]] explicit operator bool() const noexcept { return m_operations != nullptr; }
+
+private:
+    struct Operations
+    {
+        void (*invoke)(void* storage);
+        void (*move)(void* from, void* to) noexcept;
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template <typename Function>
+    struct InplaceOperations
+    {
+        static void invoke(void* storage) { (*static_cast<Function*>(storage))(); }
+        static void move(void* from, void* to) noexcept
+        {
+            Function* function = static_cast<Function*>(from);
+            ::new (to) Function(std::move(*function));
+            function->~Function();
+        }
+        static void destroy(void* storage) noexcept { static_cast<Function*>(storage)->~Function(); }
+    };
+
+    template <typename Function>
+    struct HeapOperations
+    {
+        static void invoke(void* storage) { (**static_cast<Function**>(storage))(); }
+        static void move(void* from, void* to) noexcept { ::new (to) Function*(*static_cast<Function**>(from)); }
+        static void destroy(void* storage) noexcept { delete *static_cast<Function**>(storage); }
+    };
+
+    template <typename Function, typename Implementation = std::conditional_t<is_stored_inplace_v<Function>,
+                                                                              InplaceOperations<Function>,
+                                                                              HeapOperations<Function>>>
+    static constexpr Operations kOperations{ &Implementation::invoke, &Implementation::move, &Implementation::destroy };
+
+    void move_from(task_function& other) noexcept
+    {
+        if (other.m_operations)
+        {
+            other.m_operations->move(other.m_buffer, m_buffer);
+            m_operations = std::exchange(other.m_operations, nullptr);
+        }
+    }
+
+private:
+    alignas(std::max_align_t) std::byte m_buffer[kBufferSize];
+    const Operations* m_operations = nullptr;
+};
+
+// Function with arguments, on call invokes function with moved arguments
+template <typename Function, typename... Args>
+class task_invoker
+{
+public:
+    static_assert(std::is_invocable_v<std::decay_t<Function>, std::decay_t<Args>&&...>,
+         "Arguments must be invocable after conversion to rvalues");
+
+    template <typename _Function, typename... _Args>
+    explicit task_invoker(_Function&& function, _Args&&... args)
+        : m_function(std::forward<_Function>(function))
+        , m_arguments(std::forward<_Args>(args)...)
+    {}
+
+    std::invoke_result_t<std::decay_t<Function>, std::decay_t<Args>&&...> operator()()
+    {
+        return std::apply(std::move(m_function), std::move(m_arguments));
+    }
+
+private:
+    std::decay_t<Function> m_function;
+    std::tuple<std::decay_t<Args>...> m_arguments;
+};
+
+// Task which result is passed to the future
+template <typename Result, typename Function, typename... Args>
+class promise_task
+{
+public:
+    template <typename _Function, typename... _Args>
+    explicit promise_task(_Function&& function, _Args&&... args)
+        : m_invoker(std::forward<_Function>(function), std::forward<_Args>(args)...)
+    {}
+
+    [[nodiscard]] std::future<Result> get_future() { return m_promise.get_future(); }
+
+    // complete the future with exception without function call
+    void set_exception(std::exception_ptr exception) { m_promise.set_exception(std::move(exception)); }
+
+    void operator()()
+    {
+        try
+        {
+            if constexpr (std::is_void_v<Result>)
+            {
+                m_invoker();
+                m_promise.set_value();
+            }
+            else
+                m_promise.set_value(m_invoker());
+        }
+        catch (...)
+        {
+            m_promise.set_exception(std::current_exception());
+        }
+    }
+
+private:
+    std::promise<Result> m_promise;
+    task_invoker<Function, Args...> m_invoker;
+};
+
+// Task with deadline, if the pool marks it as expired the future gets deadline_exceeded without function call
+template <typename Result, typename Function, typename... Args>
+class deadline_task
+{
+public:
+    template <typename _Function, typename... _Args>
+    explicit deadline_task(const bool& expired, _Function&& function, _Args&&... args)
+        : m_expired(expired)
+        , m_task(std::forward<_Function>(function), std::forward<_Args>(args)...)
+    {}
+
+    [[nodiscard]] std::future<Result> get_future() { return m_task.get_future(); }
+
+    void operator()()
+    {
+        if (m_expired)
+            m_task.set_exception(std::make_exception_ptr(deadline_exceeded()));
+        else
+            m_task();
+    }
+
+private:
+    // expiration flag of the task information object, set by the worker before the call
+    const bool& m_expired;
+    promise_task<Result, Function, Args...> m_task;
+};
+
+// Task without result, nobody waits for it so exceptions are only traced
+template <typename Function, typename... Args>
+class detached_task
+{
+public:
+    template <typename _Function, typename... _Args>
+    explicit detached_task(_Function&& function, _Args&&... args)
+        : m_invoker(std::forward<_Function>(function), std::forward<_Args>(args)...)
+    {}
+
+    void operator()()
+    {
+        try
+        {
+            m_invoker();
+        }
+        catch (const ext::thread::thread_interrupted&)
+        {}
+        catch (...)
+        {
+            ext::ManageException(EXT_TRACE_FUNCTION);
+        }
+    }
+
+private:
+    task_invoker<Function, Args...> m_invoker;
+};
+
+// Task of the batch, marks itself done in the batch wait group on destruction so removed tasks are also done
+template <typename Function, typename... Args>
+class batch_task
+{
+public:
+    template <typename _Function, typename... _Args>
+    explicit batch_task(const std::shared_ptr<ext::WaitGroup>& waitGroup, _Function&& function, _Args&&... args)
+        : m_batchNotifier(waitGroup)
+        , m_task(std::forward<_Function>(function), std::forward<_Args>(args)...)
+    {}
+
+    void operator()() { m_task(); }
+
+private:
+    // declared first to notify the batch after the task destruction
+    struct batch_notifier
+    {
+        explicit batch_notifier(const std::shared_ptr<ext::WaitGroup>& waitGroup) noexcept
+            : waitGroup(waitGroup)
+        { waitGroup->add(); }
+        batch_notifier(batch_notifier&&) noexcept = default;
+        ~batch_notifier()
+        {
+            if (waitGroup)
+                waitGroup->done();
+        }
+
+        std::shared_ptr<ext::WaitGroup> waitGroup;
+    } m_batchNotifier;
+    detached_task<Function, Args...> m_task;
+};
+
+// Type of the range element reference
+template <typename Range>
+using range_reference_t = decltype(*std::begin(std::declval<Range&>()));
+
+// Range of indexes [0, size) without elements storage, tasks for indexes are added without allocating a container
+class index_range
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::size_t*;
+        using reference = const std::size_t&;
+
+        constexpr iterator() noexcept = default;
+        constexpr explicit iterator(std::size_t index) noexcept : m_index(index) {}
+
+        [[nodiscard]] constexpr reference operator*() const noexcept { return m_index; }
+        constexpr iterator& operator++() noexcept { ++m_index; return *this; }
+        constexpr iterator operator++(int) noexcept { return iterator(m_index++); }
+        [[nodiscard]] constexpr bool operator==(const iterator& other) const noexcept { return m_index == other.m_index; }
+        [[nodiscard]] constexpr bool operator!=(const iterator& other) const noexcept { return m_index != other.m_index; }
+
+    private:
+        std::size_t m_index = 0;
+    };
+
+    constexpr explicit index_range(std::size_t size) noexcept : m_size(size) {}
+
+    [[nodiscard]] constexpr iterator begin() const noexcept { return iterator(0); }
+    [[nodiscard]] constexpr iterator end() const noexcept { return iterator(m_size); }
+
+private:
+    std::size_t m_size;
+};
+
+// Intrusive double linked list, Node must have `Node* next` and `Node* prev` fields. List doesn't own nodes
+template <typename Node>
+class intrusive_list
+{
+public:
+    intrusive_list() noexcept = default;
+    intrusive_list(intrusive_list&& other) noexcept
+        : m_head(std::exchange(other.m_head, nullptr))
+        , m_tail(std::exchange(other.m_tail, nullptr))
+        , m_size(std::exchange(other.m_size, 0))
+    {}
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+
+    [[nodiscard]] bool empty() const noexcept { return m_head == nullptr; }
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+    [[nodiscard]] Node* front() const noexcept { return m_head; }
+    [[nodiscard]] Node* back() const noexcept { return m_tail; }
+
+    void push_back(Node* node) noexcept { insert(nullptr, node); }
+    void push_front(Node* node) noexcept { insert(m_head, node); }
+
+    // insert node before position, if position is nullptr - node is added to the end
+    void insert(Node* position, Node* node) noexcept
+    {
+        node->next = position;
+        node->prev = position ? position->prev : m_tail;
+        (node->prev ? node->prev->next : m_head) = node;
+        (position ? position->prev : m_tail) = node;
+        ++m_size;
+    }
+
+    void erase(Node* node) noexcept
+    {
+        (node->prev ? node->prev->next : m_head) = node->next;
+        (node->next ? node->next->prev : m_tail) = node->prev;
+        node->next = node->prev = nullptr;
+        --m_size;
+    }
+
+    [[nodiscard]] Node* pop_front() noexcept
+    {
+        Node* node = m_head;
+        if (node)
+            erase(node);
+        return node;
+    }
+
+    [[nodiscard]] Node* pop_back() noexcept
+    {
+        Node* node = m_tail;
+        if (node)
+            erase(node);
+        return node;
+    }
+
+    // move all nodes from other list to the end of this list
+    void splice(intrusive_list& other) noexcept
+    {
+        if (other.empty())
+            return;
+
+        other.m_head->prev = m_tail;
+        (m_tail ? m_tail->next : m_head) = other.m_head;
+        m_tail = other.m_tail;
+        m_size += other.m_size;
+        other.m_head = other.m_tail = nullptr;
+        other.m_size = 0;
+    }
+
+    // find first node which satisfies predicate, nullptr if there are no such nodes
+    template <typename Predicate>
+    [[nodiscard]] Node* find_if(Predicate&& predicate) const
+    {
+        for (Node* node = m_head; node != nullptr; node = node->next)
+        {
+            if (predicate(*node))
+                return node;
+        }
+        return nullptr;
+    }
+
+private:
+    Node* m_head = nullptr;
+    Node* m_tail = nullptr;
+    std::size_t m_size = 0;
+};
+
+// Intrusive pairing heap, Node must have `Node* heapChild`, `Node* heapNext` and `Node* heapPrev` fields, heapPrev
+// of the first child points to its parent. Less(a, b) is true if a must be popped before b. Push is O(1),
+// pop and erase of any node are amortized O(log n). Heap doesn't own nodes
+template <typename Node, typename Less>
+class intrusive_pairing_heap
+{
+public:
+    intrusive_pairing_heap() noexcept = default;
+    intrusive_pairing_heap(intrusive_pairing_heap&& other) noexcept
+        : m_root(std::exchange(other.m_root, nullptr))
+    {}
+    intrusive_pairing_heap(const intrusive_pairing_heap&) = delete;
+    intrusive_pairing_heap& operator=(const intrusive_pairing_heap&) = delete;
+
+    [[nodiscard]] bool empty() const noexcept { return m_root == nullptr; }
+    [[nodiscard]] Node* top() const noexcept { return m_root; }
+
+    void push(Node* node) noexcept
+    {
+        node->heapChild = node->heapNext = node->heapPrev = nullptr;
+        m_root = meld(m_root, node);
+    }
+
+    [[nodiscard]] Node* pop() noexcept
+    {
+        Node* node = m_root;
+        if (node)
+            erase(node);
+        return node;
+    }
+
+    void erase(Node* node) noexcept
+    {
+        Node* children = merge_pairs(node->heapChild);
+        if (node == m_root)
+            m_root = children;
+        else
+        {
+            // cut the node subtree, previous node is the parent if the node is its first child
+            (node->heapPrev->heapChild == node ? node->heapPrev->heapChild : node->heapPrev->heapNext) = node->heapNext;
+            if (node->heapNext)
+                node->heapNext->heapPrev = node->heapPrev;
+            m_root = meld(m_root, children);
+        }
+        node->heapChild = node->heapNext = node->heapPrev = nullptr;
+    }
+
+    // forget all nodes, their links are reset on the next push
+    void clear() noexcept { m_root = nullptr; }
+
+private:
+    // link two detached trees, the root with the lower value becomes the parent
+    [[nodiscard]] static Node* meld(Node* first, Node* second) noexcept
+    {
+        if (first == nullptr)
+            return second;
+        if (second == nullptr)
+            return first;
+        if (Less()(*second, *first))
+            std::swap(first, second);
+
+        second->heapNext = first->heapChild;
+        if (second->heapNext)
+            second->heapNext->heapPrev = second;
+        second->heapPrev = first;
+        first->heapChild = second;
+        first->heapNext = first->heapPrev = nullptr;
+        return first;
+    }
+
+    // meld siblings list into one tree, pairs are melded left to right and the results right to left
+    [[nodiscard]] static Node* merge_pairs(Node* first) noexcept
+    {
+        Node* pairs = nullptr;
+        while (first != nullptr)
+        {
+            Node* second = first->heapNext;
+            Node* next = second ? second->heapNext : nullptr;
+            Node* pair = meld(first, second);
+            pair->heapPrev = nullptr;
+            pair->heapNext = pairs;
+            pairs = pair;
+            first = next;
+        }
+
+        Node* result = nullptr;
+        while (pairs != nullptr)
+        {
+            Node* next = pairs->heapNext;
+            pairs->heapNext = nullptr;
+            result = meld(result, pairs);
+            pairs = next;
+        }
+        return result;
+    }
+
+private:
+    Node* m_root = nullptr;
+};
+
+} // namespace ext::thread_pool_details
@@ -0,0 +1,409 @@
+#pragma once
+
+/*
+ * Platform specific thread settings: name, cpu affinity, scheduling policy, NUMA topology and cpu limits
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <ext/core/defines.h>
+
+#if defined(_WIN32) || defined(__CYGWIN__) // windows
+#include <Windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#if defined(__linux__)
+#include <filesystem>
+#endif
+#endif
+
+namespace ext::thread_details {
+
+// thread scheduling policy, real time policies require privileges
+enum class SchedulingPolicy
+{
+    eNormal,        // default time sharing policy
+    eBatch,         // time sharing for cpu intensive non interactive threads
+    eIdle,          // executed only when there are no other threads to run
+    eFifo,          // real time, thread works till it blocks or a higher priority thread appears
+    eRoundRobin,    // real time with time slices between threads of the same priority
+};
+
+// set thread name visible in debuggers and system tools, names are truncated to 15 characters on linux
+inline bool set_thread_name(std::thread::native_handle_type handle, const std::string& name) noexcept
+{
+#if defined(_WIN32) || defined(__CYGWIN__) // windows
+    const std::wstring wideName(name.begin(), name.end());
+    return SUCCEEDED(SetThreadDescription(handle, wideName.c_str()));
+#elif defined(__linux__)
+    constexpr std::size_t kMaxNameLength = 15;
+    return pthread_setname_np(handle, name.substr(0, kMaxNameLength).c_str()) == 0;
+#else
+    EXT_UNUSED(handle);
+    EXT_UNUSED(name);
+    return false;
+#endif
+}
+
+// pin thread to the list of cpus
+inline bool set_thread_affinity(std::thread::native_handle_type handle, const std::vector<unsigned>& cpus) noexcept
+{
+    if (cpus.empty())
+        return false;
+
+#if defined(_WIN32) || defined(__CYGWIN__) // windows
+    DWORD_PTR mask = 0;
+    for (unsigned cpu : cpus)
+    {
+        if (cpu >= sizeof(DWORD_PTR) * 8)
+            return false;
+        mask |= DWORD_PTR(1) << cpu;
+    }
+    return SetThreadAffinityMask(handle, mask) != 0;
+#elif defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (unsigned cpu : cpus)
+    {
+        if (cpu >= CPU_SETSIZE)
+            return false;
+        CPU_SET(cpu, &cpuSet);
+    }
+    return pthread_setaffinity_np(handle, sizeof(cpuSet), &cpuSet) == 0;
+#else
+    EXT_UNUSED(handle);
+    return false;
+#endif
+}
+
+// set thread scheduling policy, priority is used only by real time policies
+inline bool set_thread_scheduling_policy(std::thread::native_handle_type handle, SchedulingPolicy policy, int priority) noexcept
+{
+#if defined(_WIN32) || defined(__CYGWIN__) // windows
+    int threadPriority = THREAD_PRIORITY_NORMAL;
+    switch (policy)
+    {
+    case SchedulingPolicy::eBatch:
+        threadPriority = THREAD_PRIORITY_BELOW_NORMAL;
+        break;
+    case SchedulingPolicy::eIdle:
+        threadPriority = THREAD_PRIORITY_IDLE;
+        break;
+    case SchedulingPolicy::eFifo:
+    case SchedulingPolicy::eRoundRobin:
+        threadPriority = priority > 0 ? THREAD_PRIORITY_TIME_CRITICAL : THREAD_PRIORITY_HIGHEST;
+        break;
+    default:
+        break;
+    }
+    return SetThreadPriority(handle, threadPriority) != 0;
+#elif defined(__linux__)
+    int nativePolicy = SCHED_OTHER;
+    switch (policy)
+    {
+    case SchedulingPolicy::eBatch:
+        nativePolicy = SCHED_BATCH;
+        break;
+    case SchedulingPolicy::eIdle:
+        nativePolicy = SCHED_IDLE;
+        break;
+    case SchedulingPolicy::eFifo:
+        nativePolicy = SCHED_FIFO;
+        break;
+    case SchedulingPolicy::eRoundRobin:
+        nativePolicy = SCHED_RR;
+        break;
+    default:
+        break;
+    }
+
+    sched_param param{};
+    // time sharing policies support only zero priority
+    param.sched_priority = (policy == SchedulingPolicy::eFifo || policy == SchedulingPolicy::eRoundRobin) ? priority : 0;
+    return pthread_setschedparam(handle, nativePolicy, &param) == 0;
+#else
+    EXT_UNUSED(handle);
+    EXT_UNUSED(policy);
+    EXT_UNUSED(priority);
+    return false;
+#endif
+}
+
+// parse cpus list in the linux sysfs format, for example "0-3,8,10-11"
+[[nodiscard]] inline std::vector<unsigned> parse_cpu_list(std::string_view list)
+{
+    std::vector<unsigned> cpus;
+    while (!list.empty())
+    {
+        const auto separator = list.find(',');
+        std::string_view range = list.substr(0, separator);
+        list = separator == std::string_view::npos ? std::string_view() : list.substr(separator + 1);
+
+        const auto parseNumber = [](std::string_view text, unsigned& number)
+        {
+            number = 0;
+            bool hasDigits = false;
+            for (char symbol : text)
+            {
+                if (symbol == ' ' || symbol == '\n' || symbol == '\r' || symbol == '\t')
+                    continue;
+                if (symbol < '0' || symbol > '9')
+                    return false;
+                number = number * 10 + unsigned(symbol - '0');
+                hasDigits = true;
+            }
+            return hasDigits;
+        };
+
+        unsigned first = 0, last = 0;
+        const auto dash = range.find('-');
+        if (dash == std::string_view::npos)
+        {
+            if (!parseNumber(range, first))
+                continue;
+            last = first;
+        }
+        else if (!parseNumber(range.substr(0, dash), first) || !parseNumber(range.substr(dash + 1), last) || last < first)
+            continue;
+
+        for (unsigned cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.emplace_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+// get cpus of each NUMA node, if topology is unknown - returns one node with all cpus
+[[nodiscard]] inline std::vector<std::vector<unsigned>> get_numa_nodes_cpus()
+{
+    std::vector<std::vector<unsigned>> nodes;
+#if defined(_WIN32) || defined(__CYGWIN__) // windows
+    if (ULONG highestNode = 0; GetNumaHighestNodeNumber(&highestNode))
+    {
+        for (ULONG node = 0; node <= highestNode; ++node)
+        {
+            ULONGLONG mask = 0;
+            if (!GetNumaNodeProcessorMask(static_cast<UCHAR>(node), &mask) || mask == 0)
+                continue;
+
+            std::vector<unsigned>& cpus = nodes.emplace_back();
+            for (unsigned cpu = 0; cpu < sizeof(mask) * 8; ++cpu)
+            {
+                if (mask & (ULONGLONG(1) << cpu))
+                    cpus.emplace_back(cpu);
+            }
+        }
+    }
+#elif defined(__linux__)
+    // node directories are /sys/devices/system/node/nodeN, node numbers might have gaps
+    std::vector<std::pair<unsigned long, std::vector<unsigned>>> numberedNodes;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error))
+    {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4 ||
+            !std::all_of(name.begin() + 4, name.end(), [](char symbol) { return symbol >= '0' && symbol <= '9'; }))
+            continue;
+
+        std::ifstream cpuListFile(entry.path() / "cpulist");
+        std::string cpuList;
+        if (!std::getline(cpuListFile, cpuList))
+            continue;
+        if (auto cpus = parse_cpu_list(cpuList); !cpus.empty())
+            numberedNodes.emplace_back(std::stoul(name.substr(4)), std::move(cpus));
+    }
+    std::sort(numberedNodes.begin(), numberedNodes.end());
+    for (auto& node : numberedNodes)
+    {
+        nodes.emplace_back(std::move(node.second));
+    }
+#endif
+
+    if (nodes.empty())
+    {
+        std::vector<unsigned>& cpus = nodes.emplace_back(std::max(1u, std::thread::hardware_concurrency()));
+        for (unsigned cpu = 0; cpu < cpus.size(); ++cpu)
+        {
+            cpus[cpu] = cpu;
+        }
+    }
+    return nodes;
+}
+
+// get cpus limit from the cgroup quota and period, nullopt if cpus are not limited(quota is -1 in cgroup v1)
+[[nodiscard]] inline std::optional<double> get_cgroup_cpu_limit(std::int64_t quota, std::int64_t period) noexcept
+{
+    if (quota <= 0 || period <= 0)
+        return std::nullopt;
+    return double(quota) / double(period);
+}
+
+// parse cgroup v2 cpu.max content "$MAX $PERIOD", returns cpus limit or nullopt if cpus are not limited
+[[nodiscard]] inline std::optional<double> parse_cgroup_cpu_max(std::string_view content) noexcept
+{
+    const auto parseNumber = [](std::string_view text, std::uint64_t& number)
+    {
+        number = 0;
+        for (char symbol : text)
+        {
+            if (symbol < '0' || symbol > '9')
+                return false;
+            number = number * 10 + std::uint64_t(symbol - '0');
+        }
+        return !text.empty();
+    };
+
+    while (!content.empty() && (content.back() == '\n' || content.back() == '\r' || content.back() == ' '))
+    {
+        content.remove_suffix(1);
+    }
+    const auto separator = content.find(' ');
+    std::uint64_t quota = 0, period = 0;
+    if (separator == std::string_view::npos ||
+        !parseNumber(content.substr(0, separator), quota) || !parseNumber(content.substr(separator + 1), period))
+        return std::nullopt;
+    return get_cgroup_cpu_limit(std::int64_t(quota), std::int64_t(period));
+}
+
+// read cpus limit of the process cgroup and its ancestors, the lowest limit of the hierarchy is applied.
+// Supports cgroup v2 cpu.max and cgroup v1 cpu.cfs_quota_us/cpu.cfs_period_us, nullopt if cpus are not limited
+[[nodiscard]] inline std::optional<double> read_cgroup_cpu_limit()
+{
+    std::optional<double> limit;
+#if defined(__linux__)
+    const auto readFile = [](const std::filesystem::path& path)
+    {
+        std::ifstream file(path);
+        std::string content;
+        std::getline(file, content);
+        return content;
+    };
+    const auto applyLimit = [&limit](std::optional<double> cgroupLimit)
+    {
+        if (cgroupLimit.has_value() && (!limit.has_value() || *cgroupLimit < *limit))
+            limit = cgroupLimit;
+    };
+    // cgroup directory and its ancestors till the mount point, process cgroup path might be not visible
+    // inside a container without cgroup namespace, in this case the container cgroup is mounted as the root
+    const auto forEachCgroupDirectory = [](const std::filesystem::path& mountPoint, std::string_view cgroupPath,
+                                           const auto& callback)
+    {
+        std::filesystem::path relativePath = std::filesystem::path(cgroupPath).relative_path();
+        while (true)
+        {
+            callback(mountPoint / relativePath);
+            if (relativePath.empty())
+                break;
+            relativePath = relativePath.parent_path();
+        }
+    };
+
+    // lines of /proc/self/cgroup: "0::$PATH" for cgroup v2, "$ID:$CONTROLLERS:$PATH" for cgroup v1
+    std::ifstream cgroupFile("/proc/self/cgroup");
+    for (std::string line; std::getline(cgroupFile, line);)
+    {
+        const auto controllersStart = line.find(':');
+        const auto pathStart = controllersStart == std::string::npos ? std::string::npos : line.find(':', controllersStart + 1);
+        if (pathStart == std::string::npos)
+            continue;
+
+        const std::string_view controllers = std::string_view(line).substr(controllersStart + 1, pathStart - controllersStart - 1);
+        const std::string_view cgroupPath = std::string_view(line).substr(pathStart + 1);
+        if (controllers.empty())
+        {
+            forEachCgroupDirectory("/sys/fs/cgroup", cgroupPath, [&](const std::filesystem::path& directory)
+            {
+                applyLimit(parse_cgroup_cpu_max(readFile(directory / "cpu.max")));
+            });
+            continue;
+        }
+
+        bool cpuController = false;
+        for (std::string_view list = controllers; !list.empty() && !cpuController;)
+        {
+            const auto separator = list.find(',');
+            cpuController = list.substr(0, separator) == "cpu";
+            list = separator == std::string_view::npos ? std::string_view() : list.substr(separator + 1);
+        }
+        if (!cpuController)
+            continue;
+
+        for (const char* mountPoint : { "/sys/fs/cgroup/cpu,cpuacct", "/sys/fs/cgroup/cpu" })
+        {
+            forEachCgroupDirectory(mountPoint, cgroupPath, [&](const std::filesystem::path& directory)
+            {
+                const std::string quota = readFile(directory / "cpu.cfs_quota_us");
+                const std::string period = readFile(directory / "cpu.cfs_period_us");
+                if (quota.empty() || period.empty())
+                    return;
+                try
+                {
+                    applyLimit(get_cgroup_cpu_limit(std::stoll(quota), std::stoll(period)));
+                }
+                catch (const std::exception&)
+                {}
+            });
+        }
+    }
+#endif
+    return limit;
+}
+
+// count of cpus in the process affinity mask, 0 if unknown
+[[nodiscard]] inline unsigned get_process_affinity_cpus_count() noexcept
+{
+#if defined(_WIN32) || defined(__CYGWIN__) // windows
+    DWORD_PTR processMask = 0, systemMask = 0;
+    if (!GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask))
+        return 0;
+    unsigned count = 0;
+    for (; processMask != 0; processMask &= processMask - 1)
+    {
+        ++count;
+    }
+    return count;
+#elif defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) != 0)
+        return 0;
+    return unsigned(CPU_COUNT(&cpuSet));
+#else
+    return 0;
+#endif
+}
+
+// count of threads which can run simultaneously: hardware concurrency limited by the process affinity mask
+// and the cgroup cpu quota rounded up, at least 1
+[[nodiscard]] inline unsigned get_available_concurrency() noexcept
+{
+    unsigned concurrency = std::thread::hardware_concurrency();
+    if (const unsigned affinityCpus = get_process_affinity_cpus_count(); affinityCpus != 0)
+        concurrency = concurrency == 0 ? affinityCpus : std::min(concurrency, affinityCpus);
+
+    try
+    {
+        if (const std::optional<double> limit = read_cgroup_cpu_limit(); limit.has_value())
+        {
+            const auto quotaCpus = static_cast<unsigned>(std::max(1.0, std::ceil(*limit)));
+            concurrency = concurrency == 0 ? quotaCpus : std::min(concurrency, quotaCpus);
+        }
+    }
+    catch (...)
+    {
+        // cgroup files are unavailable, use other limits
+    }
+    return std::max(1u, concurrency);
+}
+
+} // namespace ext::thread_details
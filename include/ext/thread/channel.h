@@ -13,21 +13,40 @@ std::thread([&]()
 channel.add(1);
 channel.add(10);
 channel.close();
+
+Unbounded channel, adding never waits:
+
+ext::Channel<int> unboundedChannel(ext::Channel<int>::kUnbounded);
+
+Non blocking, waiting with timeout and batch operations:
+
+if (!channel.try_add(1)) { ... }
+if (!channel.add_for(std::chrono::milliseconds(10), 1)) { ... }
+channel.add_range(values.begin(), values.end());
+
+std::optional<int> value = channel.try_get();
+value = channel.get_for(std::chrono::milliseconds(10));
+std::vector<int> batch;
+channel.get_batch(std::back_inserter(batch), 64);
 */
 
 #pragma once
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
+#include <limits>
 #include <optional>
 #include <mutex>
-#include <queue>
+#include <vector>
 
 #include <ext/core/defines.h>
 #include <ext/core/noncopyable.h>
 
+#include <ext/details/channel_details.h>
+
 namespace ext {
 
 template <typename T>
@@ -36,60 +55,19 @@ private:
     mutable std::mutex m_queue_mutex;
     mutable std::condition_variable m_queue_not_full;
     mutable std::condition_variable m_queue_not_empty;
-    std::queue<T> m_queue;
+    channel_details::segmented_queue<T> m_queue;
     const size_t m_max_size;
     std::atomic<bool> m_closed = false;
+    // ext::select calls waiting for the channel state change
+    std::vector<channel_details::select_waiter*> m_select_waiters;
 
-    class ChannelIterator {
-    public:
-        using value_type = T;
-
-    private:
-        Channel* m_channel;
-        std::optional<value_type> m_value;
-
-        constexpr ChannelIterator(Channel* channel, std::optional<value_type>&& value = std::nullopt)
-            : m_channel(channel)
-            , m_value(std::move(value))
-        {}
-
-        friend class Channel;
-    public:
-        ChannelIterator(const ChannelIterator& other) = delete;
-        constexpr explicit ChannelIterator(ChannelIterator&& other) noexcept
-            : m_channel(other.m_channel)
-            , m_value(std::move(other.m_value))
-        {
-            other.m_value = std::nullopt;
-        }
-
-        constexpr bool operator==(const ChannelIterator& other) const {
-            return m_channel == other.m_channel && !m_value.has_value() && !other.m_value.has_value();
-        }
-
-        constexpr bool operator!=(const ChannelIterator& other) const {
-            return !operator==(other);
-        }
-
-        constexpr const value_type& operator*() const { return m_value.value(); }
-
-        constexpr value_type& operator*() { return m_value.value(); }
-
-        constexpr value_type* operator->() { return &m_value.value(); }
-
-        constexpr const value_type* operator->() const { return &m_value.value(); }
-
-        ChannelIterator& operator++() EXT_THROWS(std::bad_function_call) {
-            if (!m_value.has_value()) {
-                throw std::bad_function_call();
-            }
-            m_value = m_channel->get();
-            return *this;
-        }
-    };
 public:
-    using iterator = ChannelIterator;
+    using iterator = channel_details::channel_iterator<Channel, T>;
+
+    // size of the unbounded channel, adding never waits
+    static constexpr size_t kUnbounded = std::numeric_limits<size_t>::max();
 
+    // elements are stored in the linked segments, a few drained segments are kept for reuse without allocations
     Channel(size_t size = 1) 
         : m_max_size(size)
     {}
@@ -104,8 +82,7 @@ public:
         if (m_closed) {
             throw std::bad_function_call();
         }
-        m_queue.emplace(std::forward<Args>(args)...);
-        m_queue_not_empty.notify_one();
+        push_back(std::forward<Args>(args)...);
     }
 
     [[nodiscard]] std::optional<T> get() noexcept
@@ -117,10 +94,119 @@ public:
         if (m_closed && m_queue.empty()) {
             return std::nullopt;
         }
-        const auto result = std::move(m_queue.front());
-        m_queue.pop();
-        m_queue_not_full.notify_one();
-        return result;
+        return pop_front();
+    }
+
+    // add element if the channel is not full, returns false if it is full
+    template <typename ...Args>
+    [[nodiscard]] bool try_add(Args&& ...args) EXT_THROWS(std::bad_function_call) {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (m_closed) {
+            throw std::bad_function_call();
+        }
+        if (m_queue.size() >= m_max_size) {
+            return false;
+        }
+        push_back(std::forward<Args>(args)...);
+        return true;
+    }
+
+    // add element, waits for the free place not longer than timeout, returns false on timeout
+    template <typename Rep, typename Period, typename ...Args>
+    [[nodiscard]] bool add_for(const std::chrono::duration<Rep, Period>& timeout, Args&& ...args)
+        EXT_THROWS(std::bad_function_call) {
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        const bool has_place = m_queue_not_full.wait_for(lock, timeout, [&]() {
+            return (m_queue.size() < m_max_size) || m_closed;
+        });
+        if (m_closed) {
+            throw std::bad_function_call();
+        }
+        if (!has_place) {
+            return false;
+        }
+        push_back(std::forward<Args>(args)...);
+        return true;
+    }
+
+    // add elements of the range, moves as many elements as fit into the channel under one lock,
+    // waits if the channel is full. Use std::make_move_iterator to move elements.
+    // Returns end or, if the channel is closed after adding a part of the range, the first not added element.
+    // Throws std::bad_function_call if the channel is closed before adding the first element
+    template <typename InputIt>
+    InputIt add_range(InputIt begin, InputIt end) EXT_THROWS(std::bad_function_call) {
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        bool added_any = false;
+        while (begin != end) {
+            m_queue_not_full.wait(lock, [&]() {
+                return (m_queue.size() < m_max_size) || m_closed;
+            });
+            if (m_closed) {
+                if (!added_any) {
+                    throw std::bad_function_call();
+                }
+                return begin;
+            }
+            added_any = true;
+            size_t added = 0;
+            for (; begin != end && m_queue.size() < m_max_size; ++begin, ++added) {
+                m_queue.emplace(*begin);
+            }
+            if (added == 1) {
+                m_queue_not_empty.notify_one();
+            } else {
+                m_queue_not_empty.notify_all();
+            }
+            notify_select_waiters();
+        }
+        return begin;
+    }
+
+    // get element if the channel is not empty
+    [[nodiscard]] std::optional<T> try_get() noexcept {
+        std::lock_guard<std::mutex> lock(m_queue_mutex);
+        if (m_queue.empty()) {
+            return std::nullopt;
+        }
+        return pop_front();
+    }
+
+    // get element, waits not longer than timeout, returns nullopt on timeout or if the channel is closed and empty
+    template <typename Rep, typename Period>
+    [[nodiscard]] std::optional<T> get_for(const std::chrono::duration<Rep, Period>& timeout) noexcept {
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        if (!m_queue_not_empty.wait_for(lock, timeout, [this] { return !m_queue.empty() || m_closed; }) ||
+            m_queue.empty()) {
+            return std::nullopt;
+        }
+        return pop_front();
+    }
+
+    // get up to max_count elements under one lock, waits for the first element.
+    // Returns count of elements written to out, 0 if the channel is closed and empty
+    template <typename OutputIt>
+    size_t get_batch(OutputIt out, size_t max_count) {
+        if (max_count == 0) {
+            return 0;
+        }
+        std::unique_lock<std::mutex> lock(m_queue_mutex);
+        m_queue_not_empty.wait(lock, [this] { return !m_queue.empty() || m_closed; });
+
+        size_t count = 0;
+        for (; count < max_count && !m_queue.empty(); ++count) {
+            *out = std::move(m_queue.front());
+            ++out;
+            m_queue.pop();
+        }
+        if (count == 1) {
+            m_queue_not_full.notify_one();
+        } else if (count > 1) {
+            m_queue_not_full.notify_all();
+        }
+        if (count != 0) {
+            notify_select_waiters();
+        }
+        return count;
     }
 
     void close() {
@@ -128,16 +214,45 @@ public:
         m_closed = true;
         m_queue_not_full.notify_all();
         m_queue_not_empty.notify_all();
+        notify_select_waiters();
     }
 
     void reset() {
         std::lock_guard<std::mutex> lock(m_queue_mutex);
         m_closed = false;
-        m_queue = {};
+        m_queue.clear();
+        notify_select_waiters();
+    }
+
+    [[nodiscard]] iterator begin() { return iterator(this, get()); }
+    [[nodiscard]] iterator end() { return iterator(this, std::nullopt); }
+
+private:
+    // must be called under m_queue_mutex on the not full queue
+    template <typename ...Args>
+    void push_back(Args&& ...args) {
+        m_queue.emplace(std::forward<Args>(args)...);
+        m_queue_not_empty.notify_one();
+        notify_select_waiters();
+    }
+
+    // must be called under m_queue_mutex on the non empty queue
+    [[nodiscard]] std::optional<T> pop_front() noexcept {
+        std::optional<T> result(std::move(m_queue.front()));
+        m_queue.pop();
+        m_queue_not_full.notify_one();
+        notify_select_waiters();
+        return result;
+    }
+
+    // wake ext::select calls waiting for this channel, must be called under m_queue_mutex
+    void notify_select_waiters() noexcept {
+        for (channel_details::select_waiter* waiter : m_select_waiters) {
+            waiter->notify();
+        }
     }
 
-    [[nodiscard]] iterator begin() { return ChannelIterator(this, get()); }
-    [[nodiscard]] iterator end() { return ChannelIterator(this, std::nullopt); }
+    friend struct channel_details::select_access;
 };
 
 } // namespace dadrian
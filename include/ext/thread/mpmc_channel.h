@@ -0,0 +1,291 @@
+/*
+Multi producer multi consumer bounded channel, lock free ring buffer of sequence numbered cells (Vyukov queue).
+Producers and consumers claim cells with one CAS and don't take locks while the ring is neither empty nor full,
+they spin for a short time and park only on these edges. API and closing semantics are the same as ext::Channel.
+
+ext::MpmcChannel<int> channel(1024);
+
+for (int i = 0; i < 4; ++i) {
+    std::thread([&]()
+        {
+            for (auto val : channel) {
+                ...
+            }
+        });
+}
+channel.add(1);
+channel.add(10);
+channel.close();
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+
+#include <ext/core/defines.h>
+#include <ext/core/noncopyable.h>
+
+#include <ext/details/channel_details.h>
+#include <ext/details/thread_details.h>
+
+namespace ext {
+
+template <typename T>
+class MpmcChannel : ::ext::NonCopyable {
+private:
+    // cell sequence equals to the position when the cell is free for the producer at this position
+    // and to the position + 1 when it holds the element for the consumer at this position
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) std::byte storage[sizeof(T)];
+
+        [[nodiscard]] T* get() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    // closing sets this bit in the producers position, so producers can't claim cells after the closing
+    static constexpr size_t kClosedBit = size_t(1) << (std::numeric_limits<size_t>::digits - 1);
+
+    const size_t m_mask;
+    std::unique_ptr<Cell[]> m_cells;
+
+    alignas(channel_details::kCacheLineSize) std::atomic<size_t> m_enqueue_pos = 0;
+    alignas(channel_details::kCacheLineSize) std::atomic<size_t> m_dequeue_pos = 0;
+
+    // producers wait on the full ring, consumers wait on the empty ring
+    alignas(channel_details::kCacheLineSize) std::atomic<size_t> m_parked_producers = 0;
+    std::atomic<size_t> m_parked_consumers = 0;
+    std::mutex m_park_mutex;
+    std::condition_variable m_not_full;
+    std::condition_variable m_not_empty;
+
+public:
+    using iterator = channel_details::channel_iterator<MpmcChannel, T>;
+
+    static_assert(std::is_nothrow_move_constructible_v<T>,
+                  "Element is moved into the claimed cell, moving must not throw");
+
+    // capacity is rounded up to the power of two, min capacity is 2
+    explicit MpmcChannel(size_t capacity = 1024)
+        : m_mask(round_up_to_power_of_two(capacity) - 1)
+        , m_cells(std::make_unique<Cell[]>(m_mask + 1))
+    {
+        init_cells();
+    }
+
+    ~MpmcChannel() {
+        destroy_elements();
+    }
+
+    // add element to the channel, waits while the ring is full, throws std::bad_function_call if the channel is closed
+    template <typename ...Args>
+    void add(Args&& ...args) EXT_THROWS(std::bad_function_call) {
+        if constexpr (std::is_nothrow_constructible_v<T, Args&&...>) {
+            emplace(claim_enqueue_position(), std::forward<Args>(args)...);
+        } else {
+            // construct element before claiming the cell, consumers wait for the claimed cell till it is filled
+            T element(std::forward<Args>(args)...);
+            emplace(claim_enqueue_position(), std::move(element));
+        }
+    }
+
+    // get element from the channel, waits while the ring is empty, returns nullopt if the channel is closed and empty
+    [[nodiscard]] std::optional<T> get() noexcept {
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = m_cells[pos & m_mask];
+            const auto diff = static_cast<std::intptr_t>(cell.sequence.load(std::memory_order_acquire) - (pos + 1));
+            if (diff == 0) {
+                // seq_cst pairs with the parking consumers, see the closed channel waking below
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed)) {
+                    // cells are filled out of order, the wake up of the filled next cell might be taken by
+                    // the consumer which found this cell empty, pass it to the next parked consumer
+                    if (m_parked_consumers.load(std::memory_order_seq_cst) != 0 && has_element()) {
+                        std::lock_guard<std::mutex> lock(m_park_mutex);
+                        m_not_empty.notify_one();
+                    }
+                    break;
+                }
+            } else if (diff < 0) {
+                if (!wait_not_empty()) {
+                    return std::nullopt;
+                }
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            } else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        Cell& cell = m_cells[pos & m_mask];
+        std::optional<T> result(std::move(*cell.get()));
+        cell.get()->~T();
+        // seq_cst store and load pair with the parking producer, one of them sees the other
+        cell.sequence.store(pos + m_mask + 1, std::memory_order_seq_cst);
+        if (m_parked_producers.load(std::memory_order_seq_cst) != 0) {
+            std::lock_guard<std::mutex> lock(m_park_mutex);
+            m_not_full.notify_one();
+        }
+        // consumers which waited for the elements added before the closing must see that the channel is empty now
+        if (m_parked_consumers.load(std::memory_order_seq_cst) != 0 && closed_and_empty()) {
+            std::lock_guard<std::mutex> lock(m_park_mutex);
+            m_not_empty.notify_all();
+        }
+        return result;
+    }
+
+    // close the channel, consumers get the remaining elements, adding throws std::bad_function_call
+    void close() {
+        m_enqueue_pos.fetch_or(kClosedBit, std::memory_order_seq_cst);
+        std::lock_guard<std::mutex> lock(m_park_mutex);
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+
+    // remove elements and open the channel, must not be called concurrently with other methods
+    void reset() {
+        destroy_elements();
+        init_cells();
+        m_enqueue_pos = 0;
+        m_dequeue_pos = 0;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return m_mask + 1; }
+
+    [[nodiscard]] iterator begin() { return iterator(this, get()); }
+    [[nodiscard]] iterator end() { return iterator(this, std::nullopt); }
+
+private:
+    [[nodiscard]] static size_t round_up_to_power_of_two(size_t value) noexcept {
+        // with the single cell the free and the filled sequences of the neighbour positions are equal
+        size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    void init_cells() noexcept {
+        for (size_t i = 0; i <= m_mask; ++i) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    void destroy_elements() noexcept {
+        const size_t tail = m_enqueue_pos.load() & ~kClosedBit;
+        for (size_t pos = m_dequeue_pos; pos != tail; ++pos) {
+            m_cells[pos & m_mask].get()->~T();
+        }
+        m_dequeue_pos = tail;
+    }
+
+    // claim the free cell for the new element, waits while the ring is full
+    [[nodiscard]] size_t claim_enqueue_position() EXT_THROWS(std::bad_function_call) {
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            if (pos & kClosedBit) {
+                throw std::bad_function_call();
+            }
+            const auto diff = static_cast<std::intptr_t>(
+                m_cells[pos & m_mask].sequence.load(std::memory_order_acquire) - pos);
+            if (diff == 0) {
+                // fails if the channel was closed, the closed bit is loaded into pos
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_seq_cst,
+                                                        std::memory_order_relaxed)) {
+                    // cells are freed out of order, pass the wake up of the freed next cell to the parked producer
+                    if (m_parked_producers.load(std::memory_order_seq_cst) != 0 && can_add()) {
+                        std::lock_guard<std::mutex> lock(m_park_mutex);
+                        m_not_full.notify_one();
+                    }
+                    return pos;
+                }
+            } else {
+                if (diff < 0) {
+                    wait_not_full();
+                }
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    template <typename ...Args>
+    void emplace(size_t pos, Args&& ...args) noexcept {
+        Cell& cell = m_cells[pos & m_mask];
+        ::new (static_cast<void*>(cell.storage)) T(std::forward<Args>(args)...);
+        // seq_cst store and load pair with the parking consumer, one of them sees the other
+        cell.sequence.store(pos + 1, std::memory_order_seq_cst);
+        if (m_parked_consumers.load(std::memory_order_seq_cst) != 0) {
+            std::lock_guard<std::mutex> lock(m_park_mutex);
+            m_not_empty.notify_one();
+        }
+    }
+
+    // producers position cell is free or the channel is closed
+    [[nodiscard]] bool can_add() const noexcept {
+        const size_t pos = m_enqueue_pos.load(std::memory_order_seq_cst);
+        return (pos & kClosedBit) ||
+            static_cast<std::intptr_t>(m_cells[pos & m_mask].sequence.load(std::memory_order_seq_cst) - pos) >= 0;
+    }
+
+    // consumers position cell holds the element
+    [[nodiscard]] bool has_element() const noexcept {
+        const size_t pos = m_dequeue_pos.load(std::memory_order_seq_cst);
+        return static_cast<std::intptr_t>(
+            m_cells[pos & m_mask].sequence.load(std::memory_order_seq_cst) - (pos + 1)) >= 0;
+    }
+
+    // channel is closed and all claimed cells are taken by consumers, cells claimed before the closing
+    // are going to be filled so consumers wait for them
+    [[nodiscard]] bool closed_and_empty() const noexcept {
+        const size_t tail = m_enqueue_pos.load(std::memory_order_seq_cst);
+        return (tail & kClosedBit) && (tail & ~kClosedBit) == m_dequeue_pos.load(std::memory_order_seq_cst);
+    }
+
+    // wait for the free cell, spin first and park if the ring is still full
+    void wait_not_full() {
+        thread_details::exponential_wait wait;
+        while (wait.get_step() < channel_details::kSpinSteps) {
+            wait();
+            if (can_add()) {
+                return;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_park_mutex);
+        m_parked_producers.fetch_add(1, std::memory_order_seq_cst);
+        m_not_full.wait(lock, [&]() { return can_add(); });
+        m_parked_producers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // wait for the element, spin first and park if the ring is still empty.
+    // Returns false if the channel is closed and empty
+    [[nodiscard]] bool wait_not_empty() noexcept {
+        thread_details::exponential_wait wait;
+        while (wait.get_step() < channel_details::kSpinSteps) {
+            if (closed_and_empty()) {
+                return false;
+            }
+            wait();
+            if (has_element()) {
+                return true;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_park_mutex);
+        m_parked_consumers.fetch_add(1, std::memory_order_seq_cst);
+        m_not_empty.wait(lock, [&]() { return has_element() || closed_and_empty(); });
+        m_parked_consumers.fetch_sub(1, std::memory_order_relaxed);
+        return !closed_and_empty();
+    }
+};
+
+} // namespace ext
@@ -0,0 +1,401 @@
+#pragma once
+
+/*
+ * Parallel algorithms executed on ext::thread_pool, ranges are split into chunks which are processed by the pool
+ * workers and the calling thread. Iterators must be random access.
+ * Example:
+
+#include <ext/thread/parallel.h>
+
+std::vector<int> values = { ... };
+ext::parallel::for_each(values.begin(), values.end(), [](int& value) { ++value; });
+const int sum = ext::parallel::reduce(values.begin(), values.end(), 0);
+ext::parallel::sort(values.begin(), values.end());
+
+ * Executing on the custom pool with cancellation, if stop is requested not started chunks are skipped
+ * and ext::thread::thread_interrupted is thrown:
+
+ext::stop_source stopSource;
+ext::parallel::Options options{ .threadPool = &threadPool, .stopToken = stopSource.get_token() };
+ext::parallel::transform(options, values.begin(), values.end(), values.begin(), [](int value) { return value * 2; });
+*/
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ext/details/parallel_details.h>
+
+#include <ext/thread/stop_token.h>
+#include <ext/thread/thread_pool.h>
+
+namespace ext::parallel {
+
+// parallel algorithms execution settings
+struct Options
+{
+    // pool for execution, nullptr means ext::thread_pool::GlobalInstance()
+    ext::thread_pool* threadPool = nullptr;
+    // cancellation token, checked before each chunk execution
+    ext::stop_token stopToken = {};
+    // min count of elements processed by one chunk in for_each, transform and reduce, 0 - selected automatically
+    std::size_t minChunkSize = 0;
+};
+
+/**
+ * \brief Invoke function for each element of the range in parallel
+ * \param options execution settings
+ * \param first begin of the range
+ * \param last end of the range
+ * \param function function invoked with the range element reference, called from different threads simultaneously
+ * \throw first exception thrown by function or ext::thread::thread_interrupted if stop is requested
+ */
+template <typename RandomIt, typename Function>
+void for_each(const Options& options, RandomIt first, RandomIt last, Function&& function);
+template <typename RandomIt, typename Function>
+void for_each(RandomIt first, RandomIt last, Function&& function);
+
+/**
+ * \brief Apply operation to each element of the range and store results to the destination range in parallel
+ * \param options execution settings
+ * \param first begin of the source range
+ * \param last end of the source range
+ * \param destination begin of the destination range, might be equal to first
+ * \param operation unary operation
+ * \return iterator to the element past the last transformed element
+ */
+template <typename RandomIt, typename OutputIt, typename UnaryOperation>
+OutputIt transform(const Options& options, RandomIt first, RandomIt last, OutputIt destination,
+                   UnaryOperation&& operation);
+template <typename RandomIt, typename OutputIt, typename UnaryOperation>
+OutputIt transform(RandomIt first, RandomIt last, OutputIt destination, UnaryOperation&& operation);
+
+/**
+ * \brief Reduce range in parallel, like std::reduce the operation is applied in unspecified order
+ * \param options execution settings
+ * \param first begin of the range
+ * \param last end of the range
+ * \param init initial value
+ * \param operation associative and commutative binary operation
+ * \return reduction of init and the range elements
+ */
+template <typename RandomIt, typename T, typename BinaryOperation>
+[[nodiscard]] T reduce(const Options& options, RandomIt first, RandomIt last, T init, BinaryOperation&& operation);
+template <typename RandomIt, typename T>
+[[nodiscard]] T reduce(const Options& options, RandomIt first, RandomIt last, T init);
+template <typename RandomIt>
+[[nodiscard]] typename std::iterator_traits<RandomIt>::value_type reduce(const Options& options, RandomIt first, RandomIt last);
+template <typename RandomIt, typename T, typename BinaryOperation>
+[[nodiscard]] T reduce(RandomIt first, RandomIt last, T init, BinaryOperation&& operation);
+template <typename RandomIt, typename T>
+[[nodiscard]] T reduce(RandomIt first, RandomIt last, T init);
+template <typename RandomIt>
+[[nodiscard]] typename std::iterator_traits<RandomIt>::value_type reduce(RandomIt first, RandomIt last);
+
+/**
+ * \brief Compute inclusive prefix sums of the range in parallel
+ * \param options execution settings
+ * \param first begin of the source range
+ * \param last end of the source range
+ * \param destination begin of the destination range, might be equal to first
+ * \param operation associative binary operation
+ * \return iterator to the element past the last written element
+ */
+template <typename RandomIt, typename OutputIt, typename BinaryOperation>
+OutputIt inclusive_scan(const Options& options, RandomIt first, RandomIt last, OutputIt destination,
+                        BinaryOperation&& operation);
+template <typename RandomIt, typename OutputIt>
+OutputIt inclusive_scan(const Options& options, RandomIt first, RandomIt last, OutputIt destination);
+template <typename RandomIt, typename OutputIt, typename BinaryOperation>
+OutputIt inclusive_scan(RandomIt first, RandomIt last, OutputIt destination, BinaryOperation&& operation);
+template <typename RandomIt, typename OutputIt>
+OutputIt inclusive_scan(RandomIt first, RandomIt last, OutputIt destination);
+
+/**
+ * \brief Sort range in parallel, blocks of the range are sorted separately and merged after it.
+ *        If execution is cancelled the range contains elements in unspecified order
+ * \param options execution settings
+ * \param first begin of the range
+ * \param last end of the range
+ * \param compare comparison function
+ */
+template <typename RandomIt, typename Compare>
+void sort(const Options& options, RandomIt first, RandomIt last, Compare&& compare);
+template <typename RandomIt>
+void sort(const Options& options, RandomIt first, RandomIt last);
+template <typename RandomIt, typename Compare>
+void sort(RandomIt first, RandomIt last, Compare&& compare);
+template <typename RandomIt>
+void sort(RandomIt first, RandomIt last);
+
+namespace details {
+
+// count of blocks which each participant gets in inclusive_scan
+constexpr std::size_t kScanBlocksPerParticipant = 4;
+// min count of elements in one sort block, smaller ranges are sorted with less threads
+constexpr std::size_t kMinSortBlockSize = 2048;
+
+[[nodiscard]] inline ext::thread_pool& get_thread_pool(const Options& options)
+{
+    return options.threadPool ? *options.threadPool : ext::thread_pool::GlobalInstance();
+}
+
+template <typename Iterator>
+constexpr void check_random_access_iterator() noexcept
+{
+    static_assert(std::is_base_of_v<std::random_access_iterator_tag,
+                                    typename std::iterator_traits<Iterator>::iterator_category>,
+        "Parallel algorithms support only random access iterators");
+}
+
+template <typename Body>
+void run_chunks(const Options& options, std::size_t size, std::size_t minChunkSize, Body&& body)
+{
+    parallel_details::run_chunks(get_thread_pool(options), options.stopToken, size, minChunkSize,
+                                 std::forward<Body>(body));
+}
+
+} // namespace details
+
+template <typename RandomIt, typename Function>
+void for_each(const Options& options, RandomIt first, RandomIt last, Function&& function)
+{
+    details::check_random_access_iterator<RandomIt>();
+
+    details::run_chunks(options, static_cast<std::size_t>(std::distance(first, last)), options.minChunkSize,
+        [&](std::size_t begin, std::size_t end)
+        {
+            for (auto it = first + begin, chunkEnd = first + end; it != chunkEnd; ++it)
+            {
+                std::invoke(function, *it);
+            }
+        });
+}
+
+template <typename RandomIt, typename Function>
+void for_each(RandomIt first, RandomIt last, Function&& function)
+{
+    ext::parallel::for_each(Options(), first, last, std::forward<Function>(function));
+}
+
+template <typename RandomIt, typename OutputIt, typename UnaryOperation>
+OutputIt transform(const Options& options, RandomIt first, RandomIt last, OutputIt destination,
+                   UnaryOperation&& operation)
+{
+    details::check_random_access_iterator<RandomIt>();
+    details::check_random_access_iterator<OutputIt>();
+
+    const auto size = std::distance(first, last);
+    details::run_chunks(options, static_cast<std::size_t>(size), options.minChunkSize,
+        [&](std::size_t begin, std::size_t end)
+        {
+            std::transform(first + begin, first + end, destination + begin, std::ref(operation));
+        });
+    return destination + size;
+}
+
+template <typename RandomIt, typename OutputIt, typename UnaryOperation>
+OutputIt transform(RandomIt first, RandomIt last, OutputIt destination, UnaryOperation&& operation)
+{
+    return ext::parallel::transform(Options(), first, last, destination, std::forward<UnaryOperation>(operation));
+}
+
+template <typename RandomIt, typename T, typename BinaryOperation>
+T reduce(const Options& options, RandomIt first, RandomIt last, T init, BinaryOperation&& operation)
+{
+    details::check_random_access_iterator<RandomIt>();
+
+    std::mutex resultMutex;
+    std::optional<T> result;
+    details::run_chunks(options, static_cast<std::size_t>(std::distance(first, last)), options.minChunkSize,
+        [&](std::size_t begin, std::size_t end)
+        {
+            auto it = first + begin;
+            T chunkResult = *it;
+            for (const auto chunkEnd = first + end; ++it != chunkEnd;)
+            {
+                chunkResult = std::invoke(operation, std::move(chunkResult), *it);
+            }
+
+            std::lock_guard lock(resultMutex);
+            if (result.has_value())
+                result = std::invoke(operation, std::move(*result), std::move(chunkResult));
+            else
+                result.emplace(std::move(chunkResult));
+        });
+
+    if (!result.has_value())
+        return init;
+    return std::invoke(operation, std::move(init), std::move(*result));
+}
+
+template <typename RandomIt, typename T>
+T reduce(const Options& options, RandomIt first, RandomIt last, T init)
+{
+    return ext::parallel::reduce(options, first, last, std::move(init), std::plus<>());
+}
+
+template <typename RandomIt>
+typename std::iterator_traits<RandomIt>::value_type reduce(const Options& options, RandomIt first, RandomIt last)
+{
+    return ext::parallel::reduce(options, first, last, typename std::iterator_traits<RandomIt>::value_type{});
+}
+
+template <typename RandomIt, typename T, typename BinaryOperation>
+T reduce(RandomIt first, RandomIt last, T init, BinaryOperation&& operation)
+{
+    return ext::parallel::reduce(Options(), first, last, std::move(init), std::forward<BinaryOperation>(operation));
+}
+
+template <typename RandomIt, typename T>
+T reduce(RandomIt first, RandomIt last, T init)
+{
+    return ext::parallel::reduce(Options(), first, last, std::move(init));
+}
+
+template <typename RandomIt>
+typename std::iterator_traits<RandomIt>::value_type reduce(RandomIt first, RandomIt last)
+{
+    return ext::parallel::reduce(Options(), first, last);
+}
+
+template <typename RandomIt, typename OutputIt, typename BinaryOperation>
+OutputIt inclusive_scan(const Options& options, RandomIt first, RandomIt last, OutputIt destination,
+                        BinaryOperation&& operation)
+{
+    details::check_random_access_iterator<RandomIt>();
+    details::check_random_access_iterator<OutputIt>();
+
+    using T = typename std::iterator_traits<RandomIt>::value_type;
+
+    const std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+    if (size == 0)
+        return destination;
+
+    const std::size_t blocksCount = std::min(
+        size, parallel_details::participants_count(details::get_thread_pool(options)) * details::kScanBlocksPerParticipant);
+    const auto blockBegin = [&](std::size_t block) { return block * size / blocksCount; };
+
+    // reduce all blocks except the last one
+    std::vector<std::optional<T>> blocksSums(blocksCount - 1);
+    details::run_chunks(options, blocksSums.size(), 1, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t block = begin; block < end; ++block)
+        {
+            auto it = first + blockBegin(block);
+            T sum = *it;
+            for (const auto blockEnd = first + blockBegin(block + 1); ++it != blockEnd;)
+            {
+                sum = std::invoke(operation, std::move(sum), *it);
+            }
+            blocksSums[block].emplace(std::move(sum));
+        }
+    });
+
+    // after it blocksSums[i] contains the sum of all elements before block i + 1
+    for (std::size_t block = 1; block < blocksSums.size(); ++block)
+    {
+        blocksSums[block] = std::invoke(operation, *blocksSums[block - 1], std::move(*blocksSums[block]));
+    }
+
+    details::run_chunks(options, blocksCount, 1, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t block = begin; block < end; ++block)
+        {
+            auto it = first + blockBegin(block);
+            auto output = destination + blockBegin(block);
+            T sum = block == 0 ? T(*it) : std::invoke(operation, *blocksSums[block - 1], *it);
+            *output = sum;
+            for (const auto blockEnd = first + blockBegin(block + 1); ++it != blockEnd;)
+            {
+                sum = std::invoke(operation, std::move(sum), *it);
+                *++output = sum;
+            }
+        }
+    });
+
+    return destination + size;
+}
+
+template <typename RandomIt, typename OutputIt>
+OutputIt inclusive_scan(const Options& options, RandomIt first, RandomIt last, OutputIt destination)
+{
+    return ext::parallel::inclusive_scan(options, first, last, destination, std::plus<>());
+}
+
+template <typename RandomIt, typename OutputIt, typename BinaryOperation>
+OutputIt inclusive_scan(RandomIt first, RandomIt last, OutputIt destination, BinaryOperation&& operation)
+{
+    return ext::parallel::inclusive_scan(Options(), first, last, destination,
+                                         std::forward<BinaryOperation>(operation));
+}
+
+template <typename RandomIt, typename OutputIt>
+OutputIt inclusive_scan(RandomIt first, RandomIt last, OutputIt destination)
+{
+    return ext::parallel::inclusive_scan(Options(), first, last, destination);
+}
+
+template <typename RandomIt, typename Compare>
+void sort(const Options& options, RandomIt first, RandomIt last, Compare&& compare)
+{
+    details::check_random_access_iterator<RandomIt>();
+
+    const std::size_t size = static_cast<std::size_t>(std::distance(first, last));
+
+    // power of two blocks count allows to merge them by pairs
+    const std::size_t participantsCount = parallel_details::participants_count(details::get_thread_pool(options));
+    std::size_t blocksCount = 1;
+    while (blocksCount < participantsCount && size / (blocksCount * 2) >= details::kMinSortBlockSize)
+    {
+        blocksCount *= 2;
+    }
+    const auto blockBegin = [&](std::size_t block) { return first + block * size / blocksCount; };
+
+    details::run_chunks(options, blocksCount, 1, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t block = begin; block < end; ++block)
+        {
+            std::sort(blockBegin(block), blockBegin(block + 1), std::ref(compare));
+        }
+    });
+
+    for (std::size_t mergedBlocks = 1; mergedBlocks < blocksCount; mergedBlocks *= 2)
+    {
+        details::run_chunks(options, blocksCount / (mergedBlocks * 2), 1, [&](std::size_t begin, std::size_t end)
+        {
+            for (std::size_t pair = begin; pair < end; ++pair)
+            {
+                const std::size_t firstBlock = pair * mergedBlocks * 2;
+                std::inplace_merge(blockBegin(firstBlock), blockBegin(firstBlock + mergedBlocks),
+                                   blockBegin(firstBlock + mergedBlocks * 2), std::ref(compare));
+            }
+        });
+    }
+}
+
+template <typename RandomIt>
+void sort(const Options& options, RandomIt first, RandomIt last)
+{
+    ext::parallel::sort(options, first, last, std::less<>());
+}
+
+template <typename RandomIt, typename Compare>
+void sort(RandomIt first, RandomIt last, Compare&& compare)
+{
+    ext::parallel::sort(Options(), first, last, std::forward<Compare>(compare));
+}
+
+template <typename RandomIt>
+void sort(RandomIt first, RandomIt last)
+{
+    ext::parallel::sort(Options(), first, last);
+}
+
+} // namespace ext::parallel
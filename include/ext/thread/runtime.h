@@ -0,0 +1,198 @@
+#pragma once
+
+/*
+ * Process wide runtime, owns the CPU threads budget and hands out executors: CPU pool for computations,
+ * elastic blocking pool for I/O and other blocking calls, timer and serial lanes. CPU bound components running on
+ * the runtime executors share the CPU pool threads instead of creating own pools, so they don't oversubscribe cpus.
+ * Blocking pool threads are not part of the CPU budget: they mostly wait in blocking calls, and blocking tasks taking
+ * CPU pool threads would stop the computations. Its size is limited separately by Options::maxBlockingThreadsCount.
+ * Components which are not created on the runtime keep own threads, for example ext::Scheduler::GlobalInstance or
+ * ext::tick::TickService without SetAsyncTimerScheduler(&runtime.timer()).
+ * Global runtime uses ext::thread_pool::GlobalInstance as the CPU pool, blocking pool and timer threads are started
+ * on the first usage.
+ * Example:
+
+#include <ext/thread/runtime.h>
+
+// must be called before the first usage of the global runtime and ext::thread_pool::GlobalInstance
+ext::runtime::ConfigureGlobalInstance(ext::runtime::Options{ .threadsCount = 8, .maxBlockingThreadsCount = 32 });
+
+ext::runtime& runtime = ext::runtime::GlobalInstance();
+runtime.cpu_pool().add_task([]() { ... });
+runtime.blocking_pool().add_task([]() { file.read(...); });
+// timer thread only waits for the call time, tasks are executed by the CPU pool
+runtime.timer().SubscribeTaskByPeriod([]() { ... }, std::chrono::seconds(1));
+
+ext::serial_lane lane = runtime.make_serial_lane();
+lane.add_task_detached([]() { ... });
+*/
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include <ext/core/check.h>
+#include <ext/core/noncopyable.h>
+
+#include <ext/thread/scheduler.h>
+#include <ext/thread/serial_lane.h>
+#include <ext/thread/thread_pool.h>
+
+namespace ext {
+
+class runtime : ext::NonCopyable
+{
+public:
+    struct Options
+    {
+        // threads budget for CPU bound tasks, count of the CPU pool workers
+        std::uint_fast32_t threadsCount = ext::available_concurrency();
+        // count of extra CPU pool workers which replace workers blocked in ext::blocking_region
+        std::uint_fast32_t maxCompensatingThreadsCount = 0;
+        // max count of the blocking pool threads in addition to the CPU budget, they are started on demand
+        // and stopped after blockingThreadIdleTimeout without tasks
+        std::uint_fast32_t maxBlockingThreadsCount = 64;
+        std::chrono::steady_clock::duration blockingThreadIdleTimeout = std::chrono::seconds(30);
+    };
+
+    runtime();
+    explicit runtime(const Options& options);
+
+    // global runtime, its CPU pool is ext::thread_pool::GlobalInstance so all users of the global pool share the budget
+    [[nodiscard]] static runtime& GlobalInstance();
+    // set options of the global runtime, must be called before the first usage of the global runtime
+    // and ext::thread_pool::GlobalInstance. Options of the global pool are set immediately, so the call fails
+    // if the global pool is already created
+    static void ConfigureGlobalInstance(const Options& options);
+
+    // pool for CPU bound tasks
+    [[nodiscard]] ext::thread_pool& cpu_pool() noexcept;
+    // elastic pool for tasks which block on I/O or synchronization, started on the first call
+    [[nodiscard]] ext::thread_pool& blocking_pool();
+    // scheduler passing tasks to the CPU pool, started on the first call
+    [[nodiscard]] ext::Scheduler& timer();
+    // lane executing tasks one by one on the CPU pool
+    [[nodiscard]] ext::serial_lane make_serial_lane();
+
+    [[nodiscard]] const Options& get_options() const noexcept;
+
+private:
+    runtime(const Options& options, ext::thread_pool* cpuPool);
+
+    [[nodiscard]] static ext::thread_pool::Options get_cpu_pool_options(const Options& options);
+
+    // options of the global instance set before its creation
+    struct GlobalInstanceSettings
+    {
+        std::mutex mutex;
+        std::optional<Options> options;
+        bool created = false;
+    };
+    [[nodiscard]] static GlobalInstanceSettings& global_instance_settings() noexcept;
+
+private:
+    // blocking pool starts a new thread if task waits longer, blocking tasks must not wait for each other
+    static constexpr std::chrono::milliseconds kBlockingThreadSpawnLatency = std::chrono::milliseconds(1);
+
+    const Options m_options;
+
+    // CPU pool created by this runtime, null for the global runtime
+    std::unique_ptr<ext::thread_pool> m_ownedCpuPool;
+    ext::thread_pool& m_cpuPool;
+
+    std::once_flag m_blockingPoolCreated;
+    std::unique_ptr<ext::thread_pool> m_blockingPool;
+    // destroyed before the pools, timer tasks might be passed to the CPU pool till its destruction
+    std::once_flag m_timerCreated;
+    std::unique_ptr<ext::Scheduler> m_timer;
+};
+
+inline runtime::runtime()
+    : runtime(Options{})
+{}
+
+inline runtime::runtime(const Options& options)
+    : runtime(options, nullptr)
+{}
+
+inline runtime::runtime(const Options& options, ext::thread_pool* cpuPool)
+    : m_options(options)
+    , m_ownedCpuPool(cpuPool == nullptr ? std::make_unique<ext::thread_pool>(get_cpu_pool_options(options)) : nullptr)
+    , m_cpuPool(cpuPool == nullptr ? *m_ownedCpuPool : *cpuPool)
+{}
+
+inline runtime& runtime::GlobalInstance()
+{
+    static runtime globalRuntime = []()
+    {
+        GlobalInstanceSettings& settings = global_instance_settings();
+        std::lock_guard lock(settings.mutex);
+        settings.created = true;
+        // global pool is created before the runtime, so it is destroyed after it
+        return runtime(settings.options.value_or(Options{}), &ext::thread_pool::GlobalInstance());
+    }();
+    return globalRuntime;
+}
+
+inline void runtime::ConfigureGlobalInstance(const Options& options)
+{
+    GlobalInstanceSettings& settings = global_instance_settings();
+    std::lock_guard lock(settings.mutex);
+    EXT_CHECK(!settings.created) << "Global runtime is already created";
+    // global pool might be used without the runtime, fail in the caller if it is already created
+    ext::thread_pool::ConfigureGlobalInstance(get_cpu_pool_options(options));
+    settings.options = options;
+}
+
+inline ext::thread_pool& runtime::cpu_pool() noexcept
+{
+    return m_cpuPool;
+}
+
+inline ext::thread_pool& runtime::blocking_pool()
+{
+    std::call_once(m_blockingPoolCreated, [&]()
+    {
+        ext::thread_pool::Options options;
+        options.threadsCount = 0;
+        options.maxThreadsCount = m_options.maxBlockingThreadsCount;
+        options.spawnThreadLatency = kBlockingThreadSpawnLatency;
+        options.idleThreadTimeout = m_options.blockingThreadIdleTimeout;
+        m_blockingPool = std::make_unique<ext::thread_pool>(options);
+    });
+    return *m_blockingPool;
+}
+
+inline ext::Scheduler& runtime::timer()
+{
+    std::call_once(m_timerCreated, [&]() { m_timer = std::make_unique<ext::Scheduler>(m_cpuPool); });
+    return *m_timer;
+}
+
+inline ext::serial_lane runtime::make_serial_lane()
+{
+    return ext::serial_lane(m_cpuPool);
+}
+
+inline const runtime::Options& runtime::get_options() const noexcept
+{
+    return m_options;
+}
+
+inline ext::thread_pool::Options runtime::get_cpu_pool_options(const Options& options)
+{
+    ext::thread_pool::Options poolOptions;
+    poolOptions.threadsCount = options.threadsCount;
+    poolOptions.maxCompensatingThreadsCount = options.maxCompensatingThreadsCount;
+    return poolOptions;
+}
+
+inline runtime::GlobalInstanceSettings& runtime::global_instance_settings() noexcept
+{
+    static GlobalInstanceSettings settings;
+    return settings;
+}
+
+} // namespace ext
@@ -16,17 +16,30 @@ Example:
     EXPECT_EQ(taskIdAtTime, 0);
     std::this_thread::sleep_for(std::chrono::milliseconds(1));
     EXPECT_TRUE(executed);
+
+    Scheduler with executor only waits for the tasks time and passes tasks to the thread pool, so long tasks
+    don't delay other tasks. Periodic task call is skipped while its previous call is not finished, so the task
+    is never executed concurrently with itself. Scheduler destruction waits for the passed to the pool calls:
+
+    ext::Scheduler scheduler(ext::thread_pool::GlobalInstance());
+
+    Watchdog reports tasks executing in the scheduler thread longer than the timeout by EXT_TRACE_ERR:
+
+    scheduler.EnableWatchdog(std::chrono::seconds(5));
 */
 
 #include <chrono>
 #include <map>
 #include <mutex>
 #include <optional>
+#include <utility>
 
 #include <ext/core/check.h>
 #include <ext/core/noncopyable.h>
 #include <ext/error/dump_writer.h>
 
+#include <ext/thread/thread_pool.h>
+
 namespace ext {
 
 typedef size_t TaskId;
@@ -38,6 +51,9 @@ class Scheduler : ext::NonCopyable
 {
 public:
     explicit Scheduler() noexcept;
+    // tasks are executed by the executor pool, scheduler thread only waits for the tasks call time
+    explicit Scheduler(ext::thread_pool& executor) noexcept;
+    // waits for the tasks calls passed to the executor
     virtual ~Scheduler();
 
     // Getting global instance of scheduller
@@ -56,23 +72,51 @@ public:
     // Checking is task exist
     [[nodiscard]] bool IsTaskExists(TaskId taskId) noexcept;
 
-    // Removing task by id
+    // Removing task by id, call already passed to the executor is still executed, RemoveTask doesn't wait for it
     void RemoveTask(TaskId taskId);
 
+    // Enable reporting of the tasks executing in the scheduler thread longer than hungTaskTimeout by EXT_TRACE_ERR,
+    // each task call is reported once. Tasks passed to the executor are watched by the pool watchdog,
+    // see ext::thread_pool::Options::hungTaskTimeout
+    void EnableWatchdog(std::chrono::steady_clock::duration hungTaskTimeout);
+
+    // Count of the task calls reported by the watchdog
+    [[nodiscard]] size_t GetHungTasksCount() const noexcept;
+
 private:
     // Task execution thread
     void MainThread();
+    // Watchdog thread, checks the executing task duration
+    void WatchdogThread();
 
 private:
     struct TaskInfo;
+    // task call passed to the executor, finishes the call on destruction even if the pool drops it
+    class ExecutorCall;
 
     std::map<TaskId, TaskInfo> m_tasks;
 
     std::mutex m_mutexTasks;
     std::condition_variable m_cvTasks;
 
+    // pool executing tasks, if null - tasks are executed in the scheduler thread
+    ext::thread_pool* const m_executor = nullptr;
+    // count of the task calls passed to the executor and not finished yet, guarded by m_mutexTasks
+    size_t m_executorCallsCount = 0;
+    std::condition_variable m_cvExecutorCalls;
+
     std::atomic_bool m_interrupted = false;
     std::thread m_thread;
+
+    // task executing in the scheduler thread, tracked only while the watchdog is enabled
+    mutable std::mutex m_mutexWatchdog;
+    std::condition_variable m_cvWatchdog;
+    std::atomic<std::chrono::steady_clock::duration> m_hungTaskTimeout = std::chrono::steady_clock::duration::zero();
+    TaskId m_runningTaskId = kInvalidId;
+    std::chrono::steady_clock::time_point m_runningTaskStartTime;
+    bool m_runningTaskReported = false;
+    size_t m_hungTasksCount = 0;
+    std::thread m_watchdogThread;
 };
 
 struct Scheduler::TaskInfo
@@ -81,6 +125,8 @@ struct Scheduler::TaskInfo
 
     std::chrono::system_clock::time_point nextCallTime;
     std::optional<std::chrono::system_clock::duration> callingPeriod;
+    // periodic task call passed to the executor is not finished yet
+    bool executorCallRunning = false;
 
     explicit TaskInfo(std::function<void()>&& function, std::chrono::system_clock::duration&& period) noexcept
         : task(function)
@@ -96,15 +142,67 @@ struct Scheduler::TaskInfo
     }
 };
 
+class Scheduler::ExecutorCall
+{
+public:
+    ExecutorCall(Scheduler& scheduler, TaskId taskId, bool periodic) noexcept
+        : m_scheduler(&scheduler), m_taskId(taskId), m_periodic(periodic)
+    {}
+    ExecutorCall(ExecutorCall&& other) noexcept
+        : m_scheduler(std::exchange(other.m_scheduler, nullptr)), m_taskId(other.m_taskId), m_periodic(other.m_periodic)
+    {}
+    ExecutorCall(const ExecutorCall&) = delete;
+    ExecutorCall& operator=(const ExecutorCall&) = delete;
+    ~ExecutorCall()
+    {
+        if (!m_scheduler)
+            return;
+
+        std::lock_guard<std::mutex> lock(m_scheduler->m_mutexTasks);
+        if (m_periodic)
+        {
+            // task might be removed or replaced by a new one with the same id
+            const auto it = m_scheduler->m_tasks.find(m_taskId);
+            if (it != m_scheduler->m_tasks.end())
+                it->second.executorCallRunning = false;
+        }
+        // notify under the lock, scheduler might be destroyed right after the waiter wakes up
+        if (--m_scheduler->m_executorCallsCount == 0)
+            m_scheduler->m_cvExecutorCalls.notify_all();
+    }
+
+private:
+    Scheduler* m_scheduler;
+    TaskId m_taskId;
+    bool m_periodic;
+};
+
 inline Scheduler::Scheduler() noexcept : m_thread(&Scheduler::MainThread, this)
 {}
 
+inline Scheduler::Scheduler(ext::thread_pool& executor) noexcept
+    : m_executor(&executor)
+    , m_thread(&Scheduler::MainThread, this)
+{}
+
 inline Scheduler::~Scheduler()
 {
     EXT_ASSERT(m_thread.joinable());
     m_interrupted = true;
     m_cvTasks.notify_all();
     m_thread.join();
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutexTasks);
+        m_cvExecutorCalls.wait(lock, [&] { return m_executorCallsCount == 0; });
+    }
+
+    if (m_watchdogThread.joinable())
+    {
+        { std::lock_guard<std::mutex> lock(m_mutexWatchdog); }
+        m_cvWatchdog.notify_all();
+        m_watchdogThread.join();
+    }
 }
 
 inline Scheduler& Scheduler::GlobalInstance() noexcept
@@ -166,11 +264,52 @@ inline void Scheduler::RemoveTask(TaskId taskId)
     m_cvTasks.notify_one();
 }
 
+inline void Scheduler::EnableWatchdog(std::chrono::steady_clock::duration hungTaskTimeout)
+{
+    EXT_EXPECT(hungTaskTimeout > std::chrono::steady_clock::duration::zero());
+
+    std::lock_guard<std::mutex> lock(m_mutexWatchdog);
+    m_hungTaskTimeout = hungTaskTimeout;
+    if (!m_watchdogThread.joinable())
+        m_watchdogThread = std::thread(&Scheduler::WatchdogThread, this);
+}
+
+inline size_t Scheduler::GetHungTasksCount() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutexWatchdog);
+    return m_hungTasksCount;
+}
+
+inline void Scheduler::WatchdogThread()
+{
+    std::unique_lock<std::mutex> lock(m_mutexWatchdog);
+    while (!m_interrupted)
+    {
+        const std::chrono::steady_clock::duration timeout = m_hungTaskTimeout;
+        m_cvWatchdog.wait_for(lock, std::max<std::chrono::steady_clock::duration>(timeout / 4, std::chrono::milliseconds(1)),
+                              [&] { return m_interrupted.load(); });
+
+        if (m_runningTaskId == kInvalidId || m_runningTaskReported)
+            continue;
+        const auto elapsed = std::chrono::steady_clock::now() - m_runningTaskStartTime;
+        if (elapsed < timeout)
+            continue;
+
+        m_runningTaskReported = true;
+        ++m_hungTasksCount;
+        EXT_TRACE_ERR() << EXT_TRACE_FUNCTION << "Task " << m_runningTaskId << " is running for "
+                        << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+                        << "ms in scheduler thread " << m_thread.get_id();
+    }
+}
+
 inline void Scheduler::MainThread()
 {
     while (!m_interrupted)
     {
         std::function<void()> callBack = nullptr;
+        TaskId callBackId = kInvalidId;
+        bool periodic = false;
         {
             std::unique_lock<std::mutex> lk(m_mutexTasks);
 
@@ -191,6 +330,7 @@ inline void Scheduler::MainThread()
             if (nextCallTime <= std::chrono::system_clock::now() ||
                 m_cvTasks.wait_until(lk, nextCallTime) == std::cv_status::timeout)
             {
+                callBackId = it->first;
                 if (!it->second.callingPeriod.has_value())
                 {
                     callBack = std::move(it->second.task);
@@ -199,13 +339,48 @@ inline void Scheduler::MainThread()
                 else
                 {
                     it->second.nextCallTime += std::chrono::duration_cast<std::chrono::system_clock::duration>(*it->second.callingPeriod);
-                    callBack = it->second.task;
+                    // previous call is still executing in the executor, skip this call
+                    if (!it->second.executorCallRunning)
+                    {
+                        callBack = it->second.task;
+                        periodic = true;
+                        it->second.executorCallRunning = m_executor != nullptr;
+                    }
                 }
+                if (callBack && m_executor)
+                    ++m_executorCallsCount;
             }
         }
 
+        if (!callBack)
+            continue;
+
         // executing task
-        if (callBack)
+        if (m_executor)
+        {
+            try
+            {
+                m_executor->add_task_detached([call = ExecutorCall(*this, callBackId, periodic),
+                                               callBack = std::move(callBack)]() { callBack(); });
+            }
+            catch (...)
+            {
+                ext::ManageException(EXT_TRACE_FUNCTION);
+            }
+        }
+        else if (m_hungTaskTimeout.load() != std::chrono::steady_clock::duration::zero())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutexWatchdog);
+                m_runningTaskId = callBackId;
+                m_runningTaskStartTime = std::chrono::steady_clock::now();
+                m_runningTaskReported = false;
+            }
+            callBack();
+            std::lock_guard<std::mutex> lock(m_mutexWatchdog);
+            m_runningTaskId = kInvalidId;
+        }
+        else
             callBack();
     }
 }
@@ -0,0 +1,304 @@
+/*
+Realization of select statement from GoLang for ext::Channel.
+Waits till one of the cases is ready and executes it, if several cases are ready the case is chosen randomly.
+Select doesn't poll channels, it registers one wait node in all channels and sleeps till any of them changes.
+Receive case gets nullopt if the channel is closed, send case throws std::bad_function_call if the channel is closed.
+Returns index of the executed case.
+
+ext::Channel<int> numbers;
+ext::Channel<std::string> names;
+ext::Channel<int> results;
+
+ext::select(
+    ext::receive_case(numbers, [](std::optional<int> number) { ... }),
+    ext::receive_case(names, [](std::optional<std::string> name) { ... }),
+    ext::send_case(results, 10, []() { ... }),
+    // executed if none of the channels is ready, without it select waits
+    ext::default_case([]() { ... }));
+
+ext::select(
+    ext::receive_case(numbers, [](std::optional<int> number) { ... }),
+    // executed if none of the channels become ready in time
+    ext::timeout_case(std::chrono::milliseconds(100), []() { ... }));
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <ext/core/noncopyable.h>
+
+#include <ext/details/channel_details.h>
+#include <ext/thread/channel.h>
+
+namespace ext {
+
+namespace channel_details {
+
+struct select_access {
+    template <typename T>
+    static void add_waiter(Channel<T>& channel, select_waiter* waiter) {
+        std::lock_guard<std::mutex> lock(channel.m_queue_mutex);
+        channel.m_select_waiters.push_back(waiter);
+    }
+
+    template <typename T>
+    static void remove_waiter(Channel<T>& channel, select_waiter* waiter) noexcept {
+        std::lock_guard<std::mutex> lock(channel.m_queue_mutex);
+        auto& waiters = channel.m_select_waiters;
+        waiters.erase(std::find(waiters.begin(), waiters.end(), waiter));
+    }
+
+    // returns true if channel has element or closed, value is nullopt for the closed channel
+    template <typename T>
+    [[nodiscard]] static bool try_receive(Channel<T>& channel, std::optional<T>& value) noexcept {
+        std::lock_guard<std::mutex> lock(channel.m_queue_mutex);
+        if (!channel.m_queue.empty()) {
+            value = channel.pop_front();
+            return true;
+        }
+        return channel.m_closed;
+    }
+};
+
+template <typename T, typename Callback>
+struct receive_case {
+    Channel<T>& channel;
+    Callback callback;
+
+    [[nodiscard]] bool try_execute() {
+        std::optional<T> value;
+        if (!select_access::try_receive(channel, value)) {
+            return false;
+        }
+        std::invoke(callback, std::move(value));
+        return true;
+    }
+};
+
+template <typename T, typename Callback>
+struct send_case {
+    Channel<T>& channel;
+    T value;
+    Callback callback;
+
+    [[nodiscard]] bool try_execute() EXT_THROWS(std::bad_function_call) {
+        if (!channel.try_add(std::move(value))) {
+            return false;
+        }
+        std::invoke(callback);
+        return true;
+    }
+};
+
+template <typename Callback>
+struct default_case {
+    Callback callback;
+};
+
+template <typename Callback>
+struct timeout_case {
+    std::chrono::steady_clock::duration timeout;
+    Callback callback;
+};
+
+template <typename Case>
+struct is_channel_case : std::false_type {};
+template <typename T, typename Callback>
+struct is_channel_case<receive_case<T, Callback>> : std::true_type {};
+template <typename T, typename Callback>
+struct is_channel_case<send_case<T, Callback>> : std::true_type {};
+
+template <typename Case>
+struct is_default_case : std::false_type {};
+template <typename Callback>
+struct is_default_case<default_case<Callback>> : std::true_type {};
+
+template <typename Case>
+struct is_timeout_case : std::false_type {};
+template <typename Callback>
+struct is_timeout_case<timeout_case<Callback>> : std::true_type {};
+
+template <size_t Index, typename Cases>
+[[nodiscard]] bool try_execute_case(Cases& cases) {
+    if constexpr (is_channel_case<std::tuple_element_t<Index, Cases>>::value) {
+        return std::get<Index>(cases).try_execute();
+    } else {
+        return false;
+    }
+}
+
+// try channel cases starting from the random one, returns index of the executed case or nullopt
+template <typename Cases, size_t ...Indexes>
+[[nodiscard]] std::optional<size_t> try_execute_cases(Cases& cases, std::index_sequence<Indexes...>) {
+    using try_function = bool (*)(Cases&);
+    static constexpr std::array<try_function, sizeof...(Indexes)> functions = { &try_execute_case<Indexes, Cases>... };
+
+    thread_local std::minstd_rand generator(std::random_device{}());
+    const size_t start = std::uniform_int_distribution<size_t>(0, functions.size() - 1)(generator);
+    for (size_t i = 0; i < functions.size(); ++i) {
+        const size_t index = (start + i) % functions.size();
+        if (functions[index](cases)) {
+            return index;
+        }
+    }
+    return std::nullopt;
+}
+
+// registers wait node in the channels of the cases for the lifetime of the object
+template <typename Cases>
+class select_registration : ::ext::NonCopyable {
+public:
+    select_registration(Cases& cases, select_waiter& waiter)
+        : m_cases(cases)
+        , m_waiter(waiter) {
+        try {
+            std::apply([&](auto& ...selectCases) { (register_case(selectCases), ...); }, m_cases);
+        } catch (...) {
+            // destructor is not called for the failed constructor, channels must not keep the waiter
+            unregister_cases();
+            throw;
+        }
+    }
+
+    ~select_registration() {
+        unregister_cases();
+    }
+
+private:
+    void unregister_cases() noexcept {
+        std::apply([&](auto& ...selectCases) { (unregister_case(selectCases), ...); }, m_cases);
+    }
+
+    template <typename Case>
+    void register_case(Case& selectCase) {
+        if constexpr (is_channel_case<Case>::value) {
+            select_access::add_waiter(selectCase.channel, &m_waiter);
+            ++m_registered;
+        }
+    }
+
+    template <typename Case>
+    void unregister_case(Case& selectCase) noexcept {
+        if constexpr (is_channel_case<Case>::value) {
+            // cases are registered in order, if registration failed only the first m_registered cases are registered
+            if (m_registered != 0) {
+                select_access::remove_waiter(selectCase.channel, &m_waiter);
+                --m_registered;
+            }
+        }
+    }
+
+private:
+    Cases& m_cases;
+    select_waiter& m_waiter;
+    size_t m_registered = 0;
+};
+
+} // namespace channel_details
+
+// case receiving element from the channel, callback gets std::optional<T>, nullopt if the channel is closed
+template <typename T, typename Callback>
+[[nodiscard]] auto receive_case(Channel<T>& channel, Callback&& callback) {
+    return channel_details::receive_case<T, std::decay_t<Callback>>{ channel, std::forward<Callback>(callback) };
+}
+
+// case sending value to the channel, callback is called after sending
+template <typename T, typename Value, typename Callback>
+[[nodiscard]] auto send_case(Channel<T>& channel, Value&& value, Callback&& callback) {
+    return channel_details::send_case<T, std::decay_t<Callback>>{
+        channel, T(std::forward<Value>(value)), std::forward<Callback>(callback) };
+}
+
+// case executed if no channel is ready, makes select non blocking
+template <typename Callback>
+[[nodiscard]] auto default_case(Callback&& callback) {
+    return channel_details::default_case<std::decay_t<Callback>>{ std::forward<Callback>(callback) };
+}
+
+// case executed if no channel became ready during the timeout
+template <typename Rep, typename Period, typename Callback>
+[[nodiscard]] auto timeout_case(const std::chrono::duration<Rep, Period>& timeout, Callback&& callback) {
+    return channel_details::timeout_case<std::decay_t<Callback>>{
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout), std::forward<Callback>(callback) };
+}
+
+// wait till one of the cases is ready and execute it, returns index of the executed case
+template <typename ...Cases>
+size_t select(Cases&& ...selectCases) {
+    using namespace channel_details;
+
+    constexpr size_t default_cases_count = (size_t(is_default_case<std::decay_t<Cases>>::value) + ... + 0);
+    constexpr size_t timeout_cases_count = (size_t(is_timeout_case<std::decay_t<Cases>>::value) + ... + 0);
+    static_assert(default_cases_count + timeout_cases_count <= 1, "Select can have one default or timeout case");
+    static_assert(sizeof...(Cases) > default_cases_count + timeout_cases_count, "Select must have a channel case");
+
+    using cases_tuple = std::tuple<std::decay_t<Cases>...>;
+    cases_tuple cases(std::forward<Cases>(selectCases)...);
+    constexpr auto indexes = std::index_sequence_for<Cases...>{};
+
+    // index of the default or timeout case
+    constexpr size_t fallback_index = []() {
+        constexpr bool is_fallback[] = { (is_default_case<std::decay_t<Cases>>::value ||
+                                          is_timeout_case<std::decay_t<Cases>>::value)... };
+        for (size_t i = 0; i < sizeof...(Cases); ++i) {
+            if (is_fallback[i]) {
+                return i;
+            }
+        }
+        return sizeof...(Cases);
+    }();
+    const auto execute_fallback = [&]() {
+        if constexpr (fallback_index < sizeof...(Cases)) {
+            std::invoke(std::get<fallback_index>(cases).callback);
+        }
+        return fallback_index;
+    };
+
+    if (auto index = try_execute_cases(cases, indexes)) {
+        return *index;
+    }
+    if constexpr (default_cases_count != 0) {
+        return execute_fallback();
+    }
+
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    if constexpr (timeout_cases_count != 0) {
+        deadline = std::chrono::steady_clock::now() + std::get<fallback_index>(cases).timeout;
+    }
+
+    select_waiter waiter;
+    select_registration<cases_tuple> registration(cases, waiter);
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lock(waiter.mutex);
+            waiter.signaled = false;
+        }
+        // channels could change before the registration, check them after resetting the signal
+        if (auto index = try_execute_cases(cases, indexes)) {
+            return *index;
+        }
+
+        std::unique_lock<std::mutex> lock(waiter.mutex);
+        if (deadline.has_value()) {
+            if (!waiter.cv.wait_until(lock, *deadline, [&]() { return waiter.signaled; })) {
+                lock.unlock();
+                return execute_fallback();
+            }
+        } else {
+            waiter.cv.wait(lock, [&]() { return waiter.signaled; });
+        }
+    }
+}
+
+} // namespace ext
@@ -0,0 +1,238 @@
+#pragma once
+
+/*
+ * Serial lane, executes tasks one by one in the order of adding on the ext::thread_pool workers.
+ * Lane doesn't own threads, so components which need sequential execution share pool workers instead of
+ * creating own single thread pools. Lane occupies at most one worker at a time.
+ * If the bounded pool rejects or drops the lane pool task by its overflow policy, lane tasks are executed
+ * in the thread which adds tasks to the pool. If the pool is destroyed with the queued lane pool task,
+ * lane tasks are executed in the thread destroying the pool.
+ * Example:
+
+#include <ext/thread/serial_lane.h>
+
+ext::serial_lane lane(threadPool);
+lane.add_task_detached([]() { ... });
+std::future<int> result = lane.add_task([]() { return 1; });
+lane.wait();
+*/
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include <ext/core/check.h>
+
+#include <ext/details/thread_pool_details.h>
+#include <ext/scope/defer.h>
+#include <ext/thread/thread_pool.h>
+
+namespace ext {
+
+class serial_lane
+{
+public:
+    /**
+     * \param threadPool pool for tasks execution, must outlive the lane tasks
+     */
+    explicit serial_lane(ext::thread_pool& threadPool = ext::thread_pool::GlobalInstance());
+    // queued tasks are still executed after the lane destruction
+    ~serial_lane() = default;
+
+    serial_lane(serial_lane&&) noexcept = default;
+    serial_lane& operator=(serial_lane&&) noexcept = default;
+
+    /**
+     * \brief Add task to the lane, it is executed after all previously added lane tasks
+     * \tparam Function to invoke
+     * \tparam Args list of arguments passed to function
+     * \param function execution function
+     * \param args list of arguments passed to function
+     * \return future with the function result or exception
+     */
+    template <typename Function, typename... Args>
+    std::future<std::invoke_result_t<std::decay_t<Function>, std::decay_t<Args>&&...>>
+        add_task(Function&& function, Args&&... args);
+
+    // Add task without future to the lane, task exceptions are traced
+    template <typename Function, typename... Args>
+    void add_task_detached(Function&& function, Args&&... args);
+
+    // wait till all added lane tasks are executed, must not be called from the lane task
+    void wait() const;
+    // count of queued and running lane tasks, moved lane has no tasks
+    [[nodiscard]] std::size_t tasks_count() const noexcept;
+
+private:
+    // max count of tasks executed by one pool task, after it lane gives the worker to other pool tasks
+    static constexpr std::size_t kMaxTasksPerTurn = 32;
+
+    struct State
+    {
+        explicit State(ext::thread_pool& pool) noexcept : threadPool(pool) {}
+
+        ext::thread_pool& threadPool;
+
+        // synchronization of tasks and lane state
+        std::mutex mutex;
+        std::condition_variable tasksDoneCv;
+        std::deque<thread_pool_details::task_function> tasks;
+        // lane has a task in the pool queue or executes its tasks
+        bool scheduled = false;
+        // lane task is executing now
+        bool executing = false;
+    };
+
+    // pool task executing the lane tasks, executes them on destruction if the pool didn't call it,
+    // otherwise the lane dropped or rejected by the pool would stay scheduled forever.
+    // Lane is not rescheduled on destruction, the pool might be destroyed
+    class PoolTask
+    {
+    public:
+        explicit PoolTask(std::shared_ptr<State> state) noexcept : m_state(std::move(state)) {}
+        PoolTask(PoolTask&&) noexcept = default;
+        PoolTask(const PoolTask&) = delete;
+        PoolTask& operator=(const PoolTask&) = delete;
+        ~PoolTask()
+        {
+            if (m_state)
+                execute_tasks(m_state, false);
+        }
+
+        void operator()() noexcept { execute_tasks(std::exchange(m_state, nullptr), true); }
+
+    private:
+        std::shared_ptr<State> m_state;
+    };
+
+    // put task to the lane queue and schedule the lane execution in the pool if it is not scheduled yet
+    void enqueue_task(thread_pool_details::task_function&& task);
+    // execute lane tasks, if canReschedule reschedules itself in the pool after kMaxTasksPerTurn tasks
+    static void execute_tasks(const std::shared_ptr<State>& state, bool canReschedule) noexcept;
+    // add lane pool task without the lane lock, pool might execute it in the current thread or wait for queue places
+    static void schedule(const std::shared_ptr<State>& state) noexcept;
+
+private:
+    std::shared_ptr<State> m_state;
+};
+
+inline serial_lane::serial_lane(ext::thread_pool& threadPool)
+    : m_state(std::make_shared<State>(threadPool))
+{}
+
+template <typename Function, typename... Args>
+std::future<std::invoke_result_t<std::decay_t<Function>, std::decay_t<Args>&&...>>
+    serial_lane::add_task(Function&& function, Args&&... args)
+{
+    using _Result = std::invoke_result_t<std::decay_t<Function>, std::decay_t<Args>&&...>;
+    using Task = thread_pool_details::promise_task<_Result, Function, Args...>;
+
+    thread_pool_details::task_function task;
+    std::future<_Result> resultFuture =
+        task.emplace<Task>(std::forward<Function>(function), std::forward<Args>(args)...).get_future();
+    enqueue_task(std::move(task));
+    return resultFuture;
+}
+
+template <typename Function, typename... Args>
+void serial_lane::add_task_detached(Function&& function, Args&&... args)
+{
+    using Task = thread_pool_details::detached_task<Function, Args...>;
+
+    thread_pool_details::task_function task;
+    task.emplace<Task>(std::forward<Function>(function), std::forward<Args>(args)...);
+    enqueue_task(std::move(task));
+}
+
+inline void serial_lane::wait() const
+{
+    EXT_EXPECT(m_state) << "Lane was moved";
+    std::unique_lock lock(m_state->mutex);
+    m_state->tasksDoneCv.wait(lock, [&]() { return !m_state->scheduled; });
+}
+
+inline std::size_t serial_lane::tasks_count() const noexcept
+{
+    if (!m_state)
+        return 0;
+
+    std::lock_guard lock(m_state->mutex);
+    return m_state->tasks.size() + (m_state->executing ? 1 : 0);
+}
+
+inline void serial_lane::enqueue_task(thread_pool_details::task_function&& task)
+{
+    EXT_EXPECT(m_state) << "Lane was moved";
+
+    {
+        std::lock_guard lock(m_state->mutex);
+        m_state->tasks.emplace_back(std::move(task));
+        if (m_state->scheduled)
+            return;
+        // tasks added during the scheduling rely on it
+        m_state->scheduled = true;
+    }
+    schedule(m_state);
+}
+
+inline void serial_lane::execute_tasks(const std::shared_ptr<State>& state, bool canReschedule) noexcept
+{
+    // pool executes the lane pool task in the current thread instead of queuing it if the queue is full,
+    // lane executed in such nested call doesn't reschedule itself to keep the calls depth bounded
+    thread_local std::size_t nestedExecutionsCount = 0;
+    const bool reschedule = canReschedule && nestedExecutionsCount == 0;
+    ++nestedExecutionsCount;
+    EXT_DEFER(--nestedExecutionsCount);
+
+    for (std::size_t executedTasks = 0;; ++executedTasks)
+    {
+        thread_pool_details::task_function task;
+        {
+            std::lock_guard lock(state->mutex);
+            state->executing = false;
+            if (state->tasks.empty())
+            {
+                state->scheduled = false;
+                // notify under the lock, lane might be destroyed right after the waiter wakes up
+                state->tasksDoneCv.notify_all();
+                return;
+            }
+
+            if (executedTasks != kMaxTasksPerTurn || !reschedule)
+            {
+                task = std::move(state->tasks.front());
+                state->tasks.pop_front();
+                state->executing = true;
+            }
+        }
+
+        // lane stays scheduled, continue in a new pool task to let other pool tasks run
+        if (!task)
+        {
+            schedule(state);
+            return;
+        }
+
+        // promise and detached tasks handle exceptions of the functions
+        task();
+    }
+}
+
+inline void serial_lane::schedule(const std::shared_ptr<State>& state) noexcept
+{
+    try
+    {
+        state->threadPool.add_task_detached(PoolTask(state));
+    }
+    catch (...)
+    {
+        // rejected pool task already executed the lane tasks on its destruction
+        ext::ManageException(EXT_TRACE_FUNCTION);
+    }
+}
+
+} // namespace ext
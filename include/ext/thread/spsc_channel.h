@@ -0,0 +1,224 @@
+/*
+Single producer single consumer channel, lock free ring buffer with the power of two capacity.
+Producer and consumer don't take locks while the ring is neither empty nor full, they spin for a short time
+and park only on these edges. API is the same as ext::Channel, but only one thread might add elements
+and only one thread might get them. Channel should be closed by the producer thread or after the producer
+stopped adding, element added concurrently with closing might stay in the channel after get returned nullopt.
+
+ext::SpscChannel<int> channel(1024);
+
+std::thread([&]()
+    {
+        for (auto val : channel) {
+            ...
+        }
+    });
+channel.add(1);
+channel.add(10);
+channel.close();
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+
+#include <ext/core/defines.h>
+#include <ext/core/noncopyable.h>
+
+#include <ext/details/channel_details.h>
+#include <ext/details/thread_details.h>
+
+namespace ext {
+
+template <typename T>
+class SpscChannel : ::ext::NonCopyable {
+private:
+    // element storage, elements are constructed only in the slots between head and tail
+    struct Slot {
+        alignas(T) std::byte storage[sizeof(T)];
+
+        [[nodiscard]] T* get() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    // consumer position and the producer position cached by the consumer
+    alignas(channel_details::kCacheLineSize) std::atomic<size_t> m_head = 0;
+    size_t m_cached_tail = 0;
+    // producer position and the consumer position cached by the producer
+    alignas(channel_details::kCacheLineSize) std::atomic<size_t> m_tail = 0;
+    size_t m_cached_head = 0;
+
+    alignas(channel_details::kCacheLineSize) std::atomic<bool> m_closed = false;
+    // consumer waits on the empty ring, producer waits on the full ring
+    std::atomic<bool> m_consumer_parked = false;
+    std::atomic<bool> m_producer_parked = false;
+    std::mutex m_park_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+
+public:
+    using iterator = channel_details::channel_iterator<SpscChannel, T>;
+
+    // capacity is rounded up to the power of two
+    explicit SpscChannel(size_t capacity = 1024)
+        : m_mask(round_up_to_power_of_two(capacity) - 1)
+        , m_slots(std::make_unique<Slot[]>(m_mask + 1))
+    {}
+
+    ~SpscChannel() {
+        destroy_elements();
+    }
+
+    // add element to the channel, waits while the ring is full. Must be called only from the producer thread
+    template <typename ...Args>
+    void add(Args&& ...args) EXT_THROWS(std::bad_function_call) {
+        // relaxed load sees the closing by the producer thread, concurrent closing is not synchronized, see close
+        if (m_closed.load(std::memory_order_relaxed)) {
+            throw std::bad_function_call();
+        }
+
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_cached_head > m_mask) {
+            m_cached_head = m_head.load(std::memory_order_acquire);
+            if (tail - m_cached_head > m_mask) {
+                wait_not_full(tail);
+            }
+        }
+
+        ::new (static_cast<void*>(m_slots[tail & m_mask].storage)) T(std::forward<Args>(args)...);
+        // seq_cst store and load pair with the parking consumer, one of them sees the other
+        m_tail.store(tail + 1, std::memory_order_seq_cst);
+        if (m_consumer_parked.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(m_park_mutex);
+            m_not_empty.notify_one();
+        }
+    }
+
+    // get element from the channel, waits while the ring is empty, returns nullopt if the channel is closed
+    // and empty. Must be called only from the consumer thread
+    [[nodiscard]] std::optional<T> get() noexcept {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_cached_tail) {
+            m_cached_tail = m_tail.load(std::memory_order_acquire);
+            if (head == m_cached_tail && !wait_not_empty(head)) {
+                return std::nullopt;
+            }
+        }
+
+        T* element = m_slots[head & m_mask].get();
+        std::optional<T> result(std::move(*element));
+        element->~T();
+        m_head.store(head + 1, std::memory_order_seq_cst);
+        if (m_producer_parked.load(std::memory_order_seq_cst)) {
+            std::lock_guard<std::mutex> lock(m_park_mutex);
+            m_not_full.notify_one();
+        }
+        return result;
+    }
+
+    // close the channel, consumer gets the remaining elements, adding throws std::bad_function_call.
+    // Adding doesn't synchronize with closing to keep it cheap, add racing with close might succeed
+    // after the consumer got nullopt, so close from the producer thread if all elements must be delivered
+    void close() {
+        m_closed = true;
+        std::lock_guard<std::mutex> lock(m_park_mutex);
+        m_not_full.notify_all();
+        m_not_empty.notify_all();
+    }
+
+    // remove elements and open the channel, must not be called concurrently with add and get
+    void reset() {
+        destroy_elements();
+        m_head = 0;
+        m_tail = 0;
+        m_cached_head = 0;
+        m_cached_tail = 0;
+        m_closed = false;
+    }
+
+    [[nodiscard]] size_t capacity() const noexcept { return m_mask + 1; }
+
+    [[nodiscard]] iterator begin() { return iterator(this, get()); }
+    [[nodiscard]] iterator end() { return iterator(this, std::nullopt); }
+
+private:
+    [[nodiscard]] static size_t round_up_to_power_of_two(size_t value) noexcept {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // wait for the free slot, spin first and park if the ring is still full
+    void wait_not_full(size_t tail) EXT_THROWS(std::bad_function_call) {
+        const auto has_place = [&]() {
+            m_cached_head = m_head.load(std::memory_order_seq_cst);
+            return tail - m_cached_head <= m_mask;
+        };
+
+        thread_details::exponential_wait wait;
+        while (wait.get_step() < channel_details::kSpinSteps) {
+            wait();
+            if (m_closed) {
+                throw std::bad_function_call();
+            }
+            if (has_place()) {
+                return;
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_park_mutex);
+        m_producer_parked.store(true, std::memory_order_seq_cst);
+        m_not_full.wait(lock, [&]() { return has_place() || m_closed; });
+        m_producer_parked.store(false, std::memory_order_relaxed);
+        if (m_closed) {
+            throw std::bad_function_call();
+        }
+    }
+
+    // wait for the element, spin first and park if the ring is still empty.
+    // Returns false if the channel is closed and empty
+    [[nodiscard]] bool wait_not_empty(size_t head) noexcept {
+        const auto has_element = [&]() {
+            m_cached_tail = m_tail.load(std::memory_order_seq_cst);
+            return head != m_cached_tail;
+        };
+
+        thread_details::exponential_wait wait;
+        while (wait.get_step() < channel_details::kSpinSteps) {
+            wait();
+            if (has_element()) {
+                return true;
+            }
+            if (m_closed) {
+                // elements added before the closing are visible after the closed flag
+                return has_element();
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_park_mutex);
+        m_consumer_parked.store(true, std::memory_order_seq_cst);
+        m_not_empty.wait(lock, [&]() { return has_element() || m_closed; });
+        m_consumer_parked.store(false, std::memory_order_relaxed);
+        return has_element();
+    }
+
+    void destroy_elements() noexcept {
+        for (size_t head = m_head, tail = m_tail; head != tail; ++head) {
+            m_slots[head & m_mask].get()->~T();
+        }
+        m_head = m_tail.load();
+    }
+};
+
+} // namespace ext
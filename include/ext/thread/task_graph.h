@@ -0,0 +1,415 @@
+#pragma once
+
+/*
+ * Tasks dependency graph executor, each node is executed on ext::thread_pool when all its dependencies are done.
+ * Workers never wait for dependencies, ready nodes are scheduled by the worker which finished the last dependency.
+ * Graph might be executed many times.
+ * Example:
+
+#include <ext/thread/task_graph.h>
+
+ext::task_graph graph;
+const auto a = graph.add_node([]() { ... });
+const auto b = graph.add_node([]() { ... });
+// c is executed after a and b
+const auto c = graph.add_node([]() { ... }, { a, b });
+
+graph.run();
+graph.wait();
+const auto timing = graph.get_node_timing(c);
+*/
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <ext/core/check.h>
+#include <ext/core/noncopyable.h>
+
+#include <ext/thread/thread_pool.h>
+
+namespace ext {
+
+class task_graph : ext::NonCopyable
+{
+public:
+    // node identifier, index of the node in the graph
+    typedef std::size_t NodeId;
+
+    // node execution timing of the last run
+    struct NodeTiming
+    {
+        // false if node was not executed because one of the previous nodes failed
+        bool executed = false;
+        // node execution start time relative to the run start
+        std::chrono::steady_clock::duration startOffset = {};
+        std::chrono::steady_clock::duration duration = {};
+    };
+
+    /**
+     * \param threadPool pool for nodes execution
+     */
+    explicit task_graph(ext::thread_pool& threadPool = ext::thread_pool::GlobalInstance()) noexcept;
+    // wait for the running graph execution end
+    ~task_graph();
+
+    /**
+     * \brief Add node to the graph, graph can't be changed during execution
+     * \param function node execution function
+     * \param dependencies nodes which must be done before this node execution
+     * \return identifier of the created node
+     */
+    NodeId add_node(std::function<void()>&& function, std::initializer_list<NodeId> dependencies = {});
+
+    // add dependency between nodes, node will be executed after the dependency
+    void add_dependency(NodeId node, NodeId dependency);
+
+    // start graph execution without waiting, throws ext::check::CheckFailedException if graph is running or has cycles.
+    // Rethrows the pool error if it doesn't accept the root nodes, the graph is not running in this case
+    void run();
+
+    // wait for the graph execution end, rethrow the first exception of the last run nodes execution.
+    // If the pool doesn't accept the ready node, the run fails with the pool error, if the pool removes
+    // the queued node without execution, the run fails with std::future_error(broken_promise).
+    // After the node failure not started nodes are not executed
+    void wait();
+
+    [[nodiscard]] bool running() const noexcept;
+    [[nodiscard]] std::size_t nodes_count() const noexcept;
+
+    // get node timing of the last finished run
+    [[nodiscard]] NodeTiming get_node_timing(NodeId node) const;
+    // get duration of the last finished run
+    [[nodiscard]] std::chrono::steady_clock::duration get_run_duration() const noexcept;
+
+private:
+    struct Node;
+    class NodeTask;
+
+    static constexpr NodeId kInvalidNodeId = std::numeric_limits<NodeId>::max();
+
+    // execute node and the next ready nodes on the current thread, schedule the rest of the ready nodes to the pool
+    void execute_node(NodeId nodeId) noexcept;
+    // check graph for cycles and collect nodes without dependencies, called under m_mutex
+    void prepare_graph();
+    // remember the first error of the run, not started nodes are not executed after it.
+    // Null exception fails the run with broken promise error if no other error happens till the run end
+    void set_failed(std::exception_ptr exception) noexcept;
+
+private:
+    ext::thread_pool& m_threadPool;
+
+    // synchronization of the graph changes and the run state
+    mutable std::mutex m_mutex;
+    std::condition_variable m_runFinishedCv;
+
+    // deque keeps nodes addresses while adding new ones
+    std::deque<Node> m_nodes;
+    // nodes without dependencies, valid if m_graphPrepared
+    std::vector<NodeId> m_rootNodes;
+    bool m_graphPrepared = false;
+
+    bool m_running = false;
+    // count of not finished nodes in the current run
+    std::atomic_size_t m_pendingNodesCount = 0;
+    // set if one of the nodes failed in the current run
+    std::atomic_bool m_failed = false;
+    std::exception_ptr m_exception;
+
+    std::chrono::steady_clock::time_point m_runStart;
+    std::chrono::steady_clock::duration m_runDuration = {};
+};
+
+struct task_graph::Node : ext::NonCopyable
+{
+    explicit Node(std::function<void()>&& function) noexcept
+        : function(std::move(function))
+    {}
+
+    std::function<void()> function;
+    // nodes which depend on this node
+    std::vector<NodeId> successors;
+    std::size_t dependenciesCount = 0;
+    // count of not finished dependencies in the current run
+    std::atomic_size_t pendingDependenciesCount = 0;
+    // next node in the list of the skipped nodes of the failed run, see execute_node
+    NodeId nextSkippedNode = kInvalidNodeId;
+    NodeTiming timing;
+};
+
+// pool task executing the node, if the pool removes it without execution the run fails and the node is
+// finished in skip mode on destruction, otherwise the run would never end
+class task_graph::NodeTask
+{
+public:
+    NodeTask(task_graph& graph, NodeId nodeId) noexcept : m_graph(&graph), m_nodeId(nodeId) {}
+    NodeTask(NodeTask&& other) noexcept : m_graph(std::exchange(other.m_graph, nullptr)), m_nodeId(other.m_nodeId) {}
+    NodeTask(const NodeTask&) = delete;
+    NodeTask& operator=(const NodeTask&) = delete;
+    ~NodeTask()
+    {
+        if (!m_graph)
+            return;
+        m_graph->set_failed(nullptr);
+        m_graph->execute_node(m_nodeId);
+    }
+
+    void operator()() noexcept { std::exchange(m_graph, nullptr)->execute_node(m_nodeId); }
+
+private:
+    task_graph* m_graph;
+    NodeId m_nodeId;
+};
+
+inline task_graph::task_graph(ext::thread_pool& threadPool) noexcept
+    : m_threadPool(threadPool)
+{}
+
+inline task_graph::~task_graph()
+{
+    std::unique_lock lock(m_mutex);
+    m_runFinishedCv.wait(lock, [&]() { return !m_running; });
+}
+
+inline task_graph::NodeId task_graph::add_node(std::function<void()>&& function, std::initializer_list<NodeId> dependencies)
+{
+    std::lock_guard lock(m_mutex);
+    EXT_CHECK(!m_running) << "Can't change running graph";
+    EXT_CHECK(!!function) << "Empty node function";
+
+    const NodeId nodeId = m_nodes.size();
+    for (NodeId dependency : dependencies)
+    {
+        EXT_CHECK(dependency < nodeId) << "Unknown node";
+    }
+
+    Node& node = m_nodes.emplace_back(std::move(function));
+    for (NodeId dependency : dependencies)
+    {
+        m_nodes[dependency].successors.emplace_back(nodeId);
+        ++node.dependenciesCount;
+    }
+    m_graphPrepared = false;
+    return nodeId;
+}
+
+inline void task_graph::add_dependency(NodeId node, NodeId dependency)
+{
+    std::lock_guard lock(m_mutex);
+    EXT_CHECK(!m_running) << "Can't change running graph";
+    EXT_CHECK(node < m_nodes.size() && dependency < m_nodes.size()) << "Unknown node";
+    EXT_CHECK(node != dependency) << "Node can't depend on itself";
+
+    m_nodes[dependency].successors.emplace_back(node);
+    ++m_nodes[node].dependenciesCount;
+    m_graphPrepared = false;
+}
+
+inline void task_graph::run()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        EXT_CHECK(!m_running) << "Graph is already running";
+        prepare_graph();
+
+        m_exception = nullptr;
+        m_failed = false;
+        m_runStart = std::chrono::steady_clock::now();
+        if (m_nodes.empty())
+        {
+            m_runDuration = {};
+            return;
+        }
+
+        for (auto& node : m_nodes)
+        {
+            node.pendingDependenciesCount = node.dependenciesCount;
+            node.timing = NodeTiming();
+        }
+        m_pendingNodesCount = m_nodes.size();
+        m_running = true;
+    }
+
+    try
+    {
+        std::vector<NodeTask> rootTasks;
+        rootTasks.reserve(m_rootNodes.size());
+        for (NodeId nodeId : m_rootNodes)
+        {
+            rootTasks.emplace_back(*this, nodeId);
+        }
+        m_threadPool.add_tasks(std::move(rootTasks), [](NodeTask&& task) { task(); });
+    }
+    catch (...)
+    {
+        // pool doesn't add any batch task on failure, not added root tasks already finished the whole graph
+        // in skip mode on their destruction, the run is not started
+        std::lock_guard lock(m_mutex);
+        m_running = false;
+        m_exception = nullptr;
+        m_failed = false;
+        m_runFinishedCv.notify_all();
+        throw;
+    }
+}
+
+inline void task_graph::wait()
+{
+    std::unique_lock lock(m_mutex);
+    m_runFinishedCv.wait(lock, [&]() { return !m_running; });
+    if (m_exception)
+        std::rethrow_exception(m_exception);
+}
+
+inline bool task_graph::running() const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    return m_running;
+}
+
+inline std::size_t task_graph::nodes_count() const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    return m_nodes.size();
+}
+
+inline task_graph::NodeTiming task_graph::get_node_timing(NodeId node) const
+{
+    std::lock_guard lock(m_mutex);
+    EXT_CHECK(!m_running) << "Timing is available after the run end";
+    EXT_CHECK(node < m_nodes.size()) << "Unknown node";
+    return m_nodes[node].timing;
+}
+
+inline std::chrono::steady_clock::duration task_graph::get_run_duration() const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    return m_runDuration;
+}
+
+inline void task_graph::execute_node(NodeId nodeId) noexcept
+{
+    // ready nodes of the failed run are finished in this thread, their functions are skipped. Nodes are linked
+    // through Node::nextSkippedNode, each node becomes ready once per run so the list doesn't allocate
+    NodeId skippedNodes = kInvalidNodeId;
+    for (NodeId nextNodeId = nodeId; nextNodeId != kInvalidNodeId;)
+    {
+        Node& node = m_nodes[nextNodeId];
+        nextNodeId = kInvalidNodeId;
+
+        if (!m_failed)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            try
+            {
+                node.function();
+            }
+            catch (...)
+            {
+                set_failed(std::current_exception());
+            }
+            node.timing.executed = true;
+            node.timing.startOffset = start - m_runStart;
+            node.timing.duration = std::chrono::steady_clock::now() - start;
+        }
+
+        // continue with the first ready successor in this thread to avoid the pool queue round trip
+        for (NodeId successor : node.successors)
+        {
+            if (--m_nodes[successor].pendingDependenciesCount != 0)
+                continue;
+
+            if (nextNodeId == kInvalidNodeId)
+                nextNodeId = successor;
+            else if (m_failed)
+            {
+                m_nodes[successor].nextSkippedNode = skippedNodes;
+                skippedNodes = successor;
+            }
+            else
+            {
+                try
+                {
+                    m_threadPool.add_task_detached(NodeTask(*this, successor));
+                }
+                catch (...)
+                {
+                    // pool rejected the node, not added task already finished it in skip mode on destruction
+                    set_failed(std::current_exception());
+                }
+            }
+        }
+
+        if (nextNodeId == kInvalidNodeId && skippedNodes != kInvalidNodeId)
+        {
+            nextNodeId = skippedNodes;
+            skippedNodes = m_nodes[skippedNodes].nextSkippedNode;
+        }
+
+        if (--m_pendingNodesCount == 0)
+        {
+            std::lock_guard lock(m_mutex);
+            if (m_failed && !m_exception)
+                m_exception = std::make_exception_ptr(std::future_error(std::future_errc::broken_promise));
+            m_runDuration = std::chrono::steady_clock::now() - m_runStart;
+            m_running = false;
+            // notify under the lock, graph might be destroyed right after the waiter wakes up
+            m_runFinishedCv.notify_all();
+        }
+    }
+}
+
+inline void task_graph::set_failed(std::exception_ptr exception) noexcept
+{
+    std::lock_guard lock(m_mutex);
+    if (!m_exception && exception)
+        m_exception = std::move(exception);
+    m_failed = true;
+}
+
+inline void task_graph::prepare_graph()
+{
+    if (m_graphPrepared)
+        return;
+
+    // Kahn's algorithm, if not all nodes are visited - graph has a cycle
+    std::vector<std::size_t> dependenciesCount(m_nodes.size());
+    std::vector<NodeId> readyNodes;
+    for (NodeId nodeId = 0; nodeId < m_nodes.size(); ++nodeId)
+    {
+        dependenciesCount[nodeId] = m_nodes[nodeId].dependenciesCount;
+        if (dependenciesCount[nodeId] == 0)
+            readyNodes.emplace_back(nodeId);
+    }
+    std::vector<NodeId> rootNodes = readyNodes;
+
+    std::size_t visitedNodesCount = 0;
+    while (!readyNodes.empty())
+    {
+        const NodeId nodeId = readyNodes.back();
+        readyNodes.pop_back();
+        ++visitedNodesCount;
+
+        for (NodeId successor : m_nodes[nodeId].successors)
+        {
+            if (--dependenciesCount[successor] == 0)
+                readyNodes.emplace_back(successor);
+        }
+    }
+    EXT_CHECK(visitedNodesCount == m_nodes.size()) << "Graph has a cycle";
+
+    m_rootNodes = std::move(rootNodes);
+    m_graphPrepared = true;
+}
+
+} // namespace ext
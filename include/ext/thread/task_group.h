@@ -0,0 +1,289 @@
+#pragma once
+
+/*
+ * Group of tasks executed on ext::thread_pool, allows to wait and cancel only the group tasks.
+ * Waiters of the group are woken only once when the last group task is done, so many independent groups
+ * might share one pool without waking each other.
+ * Example:
+
+#include <ext/thread/task_group.h>
+
+ext::task_group group;
+for (const auto& request : requests)
+{
+    group.add_task([&request]() { ... });
+}
+// rethrows the first exception of the group tasks
+group.wait();
+
+// remove queued tasks of the group and interrupt running ones
+group.cancel();
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <list>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <ext/core/noncopyable.h>
+
+#include <ext/thread/thread.h>
+#include <ext/thread/thread_pool.h>
+
+namespace ext {
+
+class task_group : ext::NonCopyable
+{
+public:
+    /**
+     * \param threadPool pool for tasks execution
+     */
+    explicit task_group(ext::thread_pool& threadPool = ext::thread_pool::GlobalInstance()) noexcept;
+    // wait for the group tasks end, exceptions of the tasks are ignored
+    ~task_group();
+
+    /**
+     * \brief Add task to the group and to the pool queue, if the group is cancelling the task is not executed
+     * \tparam Function to invoke
+     * \tparam Args list of arguments passed to function
+     * \param function execution function
+     * \param args list of arguments passed to function
+     */
+    template <typename Function, typename... Args>
+    void add_task(Function&& function, Args&&... args);
+
+    // wait till all group tasks are executed or removed, rethrow the first exception of the group tasks.
+    // Resets the cancelling state of the group
+    void wait();
+
+    // remove queued tasks of the group and interrupt running ones, wait for the interrupted tasks end.
+    // Called from the group task it doesn't wait, so group tasks might cancel the group at the same time.
+    // Tasks added after the cancel are not executed till the wait call
+    void cancel();
+
+    [[nodiscard]] bool cancelling() const noexcept;
+    // count of queued and running tasks of the group
+    [[nodiscard]] std::size_t tasks_count() const noexcept;
+
+private:
+    struct group_task
+    {
+        ext::thread_pool::TaskId id;
+        // identifier is stored by add_task after the pool accepted the task
+        bool submitted = false;
+        // task was done before add_task stored its identifier, add_task releases it
+        bool done = false;
+    };
+    // list nodes are reused through the free list, adding tasks doesn't allocate them in the steady state
+    typedef std::list<group_task> TasksList;
+
+    // removes task from the group on the pool task destruction, so removed from the pool tasks are also counted
+    class task_notifier : ext::NonCopyable
+    {
+    public:
+        task_notifier(task_group& group, TasksList::iterator task) noexcept : m_group(&group), m_task(task) {}
+        task_notifier(task_notifier&& other) noexcept
+            : m_group(std::exchange(other.m_group, nullptr)), m_task(other.m_task)
+        {}
+        ~task_notifier()
+        {
+            if (m_group)
+                m_group->on_task_done(m_task);
+        }
+
+        [[nodiscard]] task_group& group() const noexcept { return *m_group; }
+        [[nodiscard]] TasksList::iterator task() const noexcept { return m_task; }
+
+    private:
+        task_group* m_group;
+        TasksList::iterator m_task;
+    };
+
+    // pool task of the group, notifier is declared first so it is destroyed after the function and its arguments,
+    // otherwise waiters of the group might be woken while the task captured objects are still being destroyed
+    template <typename Function, typename Arguments>
+    struct pool_task
+    {
+        task_notifier notifier;
+        Function function;
+        Arguments arguments;
+
+        void operator()()
+        {
+            notifier.group().execute(notifier.task(), [&]() { std::apply(std::move(function), std::move(arguments)); });
+        }
+    };
+
+    // execute task function, store the first exception
+    template <typename Function>
+    void execute(TasksList::iterator task, Function&& function) noexcept;
+    // remove task from the group if add_task has finished with it, called on the pool task destruction
+    void on_task_done(TasksList::iterator task) noexcept;
+    // move task to the free list and wake up waiters if it was the last one, called under m_mutex
+    void release_task(TasksList::iterator task) noexcept;
+
+    // task of the group executing in the current thread, used to avoid the task self cancellation
+    [[nodiscard]] static const group_task*& current_thread_task() noexcept;
+
+private:
+    ext::thread_pool& m_threadPool;
+
+    // synchronization of m_tasks, m_freeTasks and m_exception, never held while calling the pool
+    mutable std::mutex m_mutex;
+    std::condition_variable m_tasksDoneCv;
+    // queued and running group tasks, the list size is the pending tasks counter
+    TasksList m_tasks;
+    // finished tasks nodes for reuse
+    TasksList m_freeTasks;
+    std::exception_ptr m_exception;
+    std::atomic_bool m_cancelling = false;
+};
+
+inline task_group::task_group(ext::thread_pool& threadPool) noexcept
+    : m_threadPool(threadPool)
+{}
+
+inline task_group::~task_group()
+{
+    std::unique_lock lock(m_mutex);
+    m_tasksDoneCv.wait(lock, [&]() { return m_tasks.empty(); });
+}
+
+template <typename Function, typename... Args>
+void task_group::add_task(Function&& function, Args&&... args)
+{
+    TasksList::iterator task;
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_freeTasks.empty())
+            task = m_tasks.emplace(m_tasks.end());
+        else
+        {
+            task = m_freeTasks.begin();
+            m_tasks.splice(m_tasks.end(), m_freeTasks, task);
+            *task = group_task();
+        }
+    }
+
+    // pool is called without the lock: bounded pool might execute the task in this thread or block the submitter.
+    // Notifier calls on_task_done exactly once, when the pool task is destroyed or the pool rejects it
+    ext::thread_pool::TaskId taskId;
+    try
+    {
+        using Task = pool_task<std::decay_t<Function>, decltype(std::make_tuple(std::forward<Args>(args)...))>;
+        taskId = m_threadPool.add_task_detached(
+            Task{ task_notifier(*this, task), std::forward<Function>(function), std::make_tuple(std::forward<Args>(args)...) });
+    }
+    catch (...)
+    {
+        std::lock_guard lock(m_mutex);
+        release_task(task);
+        throw;
+    }
+
+    std::lock_guard lock(m_mutex);
+    if (task->done)
+        release_task(task);
+    else
+    {
+        task->id = taskId;
+        task->submitted = true;
+    }
+}
+
+inline void task_group::wait()
+{
+    std::unique_lock lock(m_mutex);
+    m_tasksDoneCv.wait(lock, [&]() { return m_tasks.empty(); });
+    m_cancelling = false;
+    if (m_exception)
+        std::rethrow_exception(std::exchange(m_exception, nullptr));
+}
+
+inline void task_group::cancel()
+{
+    // tasks which are not submitted yet check the cancelling flag before the execution
+    std::vector<ext::thread_pool::TaskId> tasks;
+    const group_task* currentTask = current_thread_task();
+    {
+        std::lock_guard lock(m_mutex);
+        m_cancelling = true;
+        for (const auto& task : m_tasks)
+        {
+            // cancel called from the group task, it can't wait for itself
+            if (task.submitted && &task != currentTask)
+                tasks.emplace_back(task.id);
+        }
+    }
+
+    // group tasks cancelling each other would wait for each other forever
+    for (const auto& taskId : tasks)
+    {
+        m_threadPool.stop_and_remove_task(taskId, currentTask == nullptr);
+    }
+}
+
+inline bool task_group::cancelling() const noexcept
+{
+    return m_cancelling;
+}
+
+inline std::size_t task_group::tasks_count() const noexcept
+{
+    std::lock_guard lock(m_mutex);
+    return m_tasks.size();
+}
+
+template <typename Function>
+void task_group::execute(TasksList::iterator task, Function&& function) noexcept
+{
+    if (m_cancelling)
+        return;
+
+    const group_task* previousTask = std::exchange(current_thread_task(), &*task);
+    try
+    {
+        function();
+    }
+    catch (const ext::thread::thread_interrupted&)
+    {
+        // task was interrupted by the group cancellation
+    }
+    catch (...)
+    {
+        std::lock_guard lock(m_mutex);
+        if (!m_exception)
+            m_exception = std::current_exception();
+    }
+    current_thread_task() = previousTask;
+}
+
+inline void task_group::on_task_done(TasksList::iterator task) noexcept
+{
+    std::lock_guard lock(m_mutex);
+    if (task->submitted)
+        release_task(task);
+    else
+        task->done = true;
+}
+
+inline void task_group::release_task(TasksList::iterator task) noexcept
+{
+    m_freeTasks.splice(m_freeTasks.end(), m_tasks, task);
+    // notify under the lock, group might be destroyed right after the waiter wakes up
+    if (m_tasks.empty())
+        m_tasksDoneCv.notify_all();
+}
+
+inline const task_group::group_task*& task_group::current_thread_task() noexcept
+{
+    thread_local const group_task* task = nullptr;
+    return task;
+}
+
+} // namespace ext
@@ -25,6 +25,17 @@ ext::thread myThread(thread_function, []()
 
 myThread.interrupt();
 EXPECT_TRUE(myThread.interrupted());
+
+ * Thread settings, functions return false if the setting is not supported or not allowed:
+
+myThread.set_name("network");
+myThread.set_affinity({ 0, 1 });
+myThread.set_scheduling_policy(ext::thread::SchedulingPolicy::eFifo, 10);
+
+ * Count of threads which can run simultaneously, takes into account the process cpu affinity and the cgroup cpu quota,
+ * so the pool in a container with 4 cpus quota gets 4 threads instead of the host cores count:
+
+ext::thread_pool threadPool(ext::available_concurrency());
  */
 #include <atomic>
 #include <chrono>
@@ -32,7 +43,9 @@ EXPECT_TRUE(myThread.interrupted());
 #include <memory>
 #include <thread>
 #include <shared_mutex>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <ext/core/defines.h>
 #include <ext/core/check.h>
@@ -44,6 +57,7 @@ EXPECT_TRUE(myThread.interrupted());
 #include <ext/thread/stop_token.h>
 
 #include <ext/details/thread_details.h>
+#include <ext/details/thread_settings_details.h>
 
 #include <ext/utils/invoke.h>
 
@@ -80,9 +94,19 @@ void sleep_until(const std::chrono::time_point<_Clock, _Duration>& absoluteTime)
 // Sleep for time duration
 template <class _Rep, class _Period>
 inline void sleep_for(const std::chrono::duration<_Rep, _Period>& timeDuration);
+// Set current thread name visible in debuggers and system tools, linux truncates names to 15 characters
+inline bool set_name(const std::string& name) noexcept;
+// Pin current thread to cpus
+inline bool set_affinity(const std::vector<unsigned>& cpus) noexcept;
+// Change current thread scheduling policy, priority is used only by real time policies
+inline bool set_scheduling_policy(ext::thread_details::SchedulingPolicy policy, int priority = 0) noexcept;
 
 } // namespace this_thread
 
+// count of threads which can run simultaneously in the current process: hardware concurrency limited by the process
+// cpu affinity and the cgroup v1/v2 cpu quota, at least 1. Calculated once on the first call
+[[nodiscard]] inline unsigned available_concurrency() noexcept;
+
 // predefine thread pool class, it need access to restore_interrupted function
 class thread_pool;
 
@@ -156,6 +180,27 @@ public:
         return false;
     }
 
+    // thread scheduling policy, real time policies require privileges
+    using SchedulingPolicy = thread_details::SchedulingPolicy;
+
+    // set thread name visible in debuggers and system tools, linux truncates names to 15 characters
+    bool set_name(const std::string& name) noexcept
+    {
+        return joinable() && thread_details::set_thread_name(native_handle(), name);
+    }
+
+    // pin thread to cpus, returns false if thread is not running or cpus are not available
+    bool set_affinity(const std::vector<unsigned>& cpus) noexcept
+    {
+        return joinable() && thread_details::set_thread_affinity(native_handle(), cpus);
+    }
+
+    // change thread scheduling policy, priority is used only by real time policies
+    bool set_scheduling_policy(SchedulingPolicy policy, int priority = 0) noexcept
+    {
+        return joinable() && thread_details::set_thread_scheduling_policy(native_handle(), policy, priority);
+    }
+
     // try join until time point
     template <class Clock, class Duration>
     bool try_join_until(const std::chrono::time_point<Clock, Duration>& time) EXT_THROWS();
@@ -512,5 +557,37 @@ void sleep_for(const std::chrono::duration<_Rep, _Period>& duration)
     ext::thread_details::sleep_for(duration);
 }
 
+// Native handle of the current thread
+[[nodiscard]] inline std::thread::native_handle_type current_native_handle() noexcept
+{
+#if defined(_WIN32) || defined(__CYGWIN__) // windows
+    return GetCurrentThread();
+#else
+    return pthread_self();
+#endif
+}
+
+inline bool set_name(const std::string& name) noexcept
+{
+    return ext::thread_details::set_thread_name(current_native_handle(), name);
+}
+
+inline bool set_affinity(const std::vector<unsigned>& cpus) noexcept
+{
+    return ext::thread_details::set_thread_affinity(current_native_handle(), cpus);
+}
+
+inline bool set_scheduling_policy(ext::thread_details::SchedulingPolicy policy, int priority) noexcept
+{
+    return ext::thread_details::set_thread_scheduling_policy(current_native_handle(), policy, priority);
+}
+
 } // namespace this_thread
+
+inline unsigned available_concurrency() noexcept
+{
+    static const unsigned concurrency = ext::thread_details::get_available_concurrency();
+    return concurrency;
+}
+
 } // namespace ext
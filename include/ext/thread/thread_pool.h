@@ -6,13 +6,13 @@
 
 #include <ext/thread/thread_pool.h>
 
-std::set<ext::TaskId, ext::TaskIdHelper> taskList;
-ext::thread_pool threadPool([&taskList, &listMutex](const ext::TaskId& taskId)
+std::set<ext::thread_pool::TaskId> taskList;
+ext::thread_pool threadPool([&taskList, &listMutex](const ext::thread_pool::TaskId& taskId)
 {
     taskList.erase(taskId);
 });
 
-const auto maxThreads = std::thread::hardware_concurrency();
+const auto maxThreads = ext::available_concurrency();
 for (auto i = maxThreads; i != 0; --i)
 {
     taskList.emplace(threadPool.add_task([]()
@@ -21,25 +21,141 @@ for (auto i = maxThreads; i != 0; --i)
     }));
 }
 threadPool.wait_for_tasks();
+
+ * Fire-and-forget tasks without futures, submission doesn't allocate memory if function with arguments fits
+ * into ext::thread_pool_details::task_function::kBufferSize:
+
+threadPool.add_task_detached([]() { ... });
+
+ * Batch of tasks, added under one lock, each function call gets one element of the range:
+
+std::vector<int> values = { ... };
+ext::thread_pool::TasksBatch batch = threadPool.add_tasks(values, [](int value) { ... });
+batch.wait();
+
+ * Work stealing mode, each worker has own tasks queue. Tasks added from the worker thread are put into its queue
+ * and executed by the same worker, idle workers steal tasks from the queues of the busy ones:
+
+ext::thread_pool threadPool(ext::thread_pool::Options{ .workStealing = true });
+threadPool.add_task([&threadPool]()
+{
+    // will be added to the current worker queue
+    threadPool.add_task([]() { ... });
+});
+threadPool.wait_for_tasks();
+
+ * Priority levels, tasks of each level are executed in the order of adding, tasks with the higher level go first.
+ * With aging tasks waiting longer than agingTime are executed before the tasks with the higher priority:
+
+ext::thread_pool threadPool(ext::thread_pool::Options{ .priorityLevelsCount = 4, .agingTime = std::chrono::seconds(1) });
+threadPool.add_task_with_priority(3, []() { ... });
+
+ * Elastic pool, threadsCount threads are always working, extra threads up to maxThreadsCount are started when tasks
+ * wait in the queue longer than spawnThreadLatency and stopped after idleThreadTimeout without tasks:
+
+ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2, .maxThreadsCount = 16,
+                                                       .spawnThreadLatency = std::chrono::milliseconds(10) });
+const ext::thread_pool::ThreadsCounters counters = threadPool.get_threads_counters();
+
+ * Workers placement, workers are named and pinned round-robin to the cpus. In NUMA aware mode workers are distributed
+ * over NUMA nodes and tasks added from the node workers are put into the node queue to keep tasks and data on one node:
+
+ext::thread_pool pinnedPool(ext::thread_pool::Options{ .threadsName = "worker", .workersCpus = { 2, 3, 4, 5 } });
+ext::thread_pool numaPool(ext::thread_pool::Options{ .numaAware = true });
+
+ * Spin then park idle strategy, idle workers spin and yield before sleeping, submitters don't wake sleeping workers
+ * if a spinning one will take the task. Reduces latency of the rare tasks at the cost of some cpu time:
+
+ext::thread_pool threadPool(ext::thread_pool::Options{ .idleSpinSteps = 8 });
+
+ * Tasks with deadline, tasks which are not started before the deadline are dropped and their futures get
+ * thread_pool::deadline_exceeded. Optionally tasks with deadlines are executed in the earliest deadline first order:
+
+ext::thread_pool threadPool(ext::thread_pool::Options{ .earliestDeadlineFirst = true });
+auto [taskId, future] = threadPool.add_task_with_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(100),
+                                                         []() { ... });
+
+ * Fair share queues, tenants sharing one pool get named queues with weights. Queues and the common queue of the normal
+ * priority tasks are served in deficit round robin order, each queue executes up to weight tasks in its turn:
+
+ext::thread_pool::QueueId tenantQueue = threadPool.add_queue("tenant", 3);
+threadPool.add_task_to_queue(tenantQueue, []() { ... });
+const ext::thread_pool::QueueStats stats = threadPool.get_queue_stats(tenantQueue);
+
+ * Bounded queue, adding tasks to the full queue blocks the submitter, throws thread_pool::queue_overflow, executes task
+ * in the caller thread or drops the oldest queued task. try_add_task fails without allocations if the queue is full:
+
+ext::thread_pool threadPool(ext::thread_pool::Options{ .queueCapacity = 1000,
+                                                       .overflowPolicy = ext::thread_pool::OverflowPolicy::eReject });
+if (auto task = threadPool.try_add_task([]() { ... }); !task.has_value())
+    ...
+
+ * Fork-join, worker waiting for the subtask future executes queued tasks, so it doesn't block the pool:
+
+threadPool.add_task([&]()
+{
+    auto subtask = threadPool.add_task([]() { ... });
+    threadPool.wait(subtask.second);
+});
+
+ * Blocking regions, worker which is going to block on I/O or on synchronization marks it by ext::blocking_region,
+ * the pool starts a compensating worker for the region time so CPU bound tasks are not starved:
+
+ext::thread_pool threadPool(ext::thread_pool::Options{ .maxCompensatingThreadsCount = 4 });
+threadPool.add_task([]()
+{
+    ext::blocking_region blocking;
+    file.read(...);
+});
+
+ * Hung tasks watchdog, tasks running longer than hungTaskTimeout are reported by EXT_TRACE_ERR with the task identifier,
+ * the worker thread and the elapsed time. Optionally the watchdog interrupts the worker thread of the hung task:
+
+ext::thread_pool threadPool(ext::thread_pool::Options{ .hungTaskTimeout = std::chrono::seconds(10),
+                                                       .interruptHungTasks = true });
+
+ * Runtime metrics, per worker counters and histograms are collected only if collectMetrics is set:
+
+ext::thread_pool threadPool(ext::thread_pool::Options{ .collectMetrics = true });
+const ext::thread_pool::Metrics metrics = threadPool.get_metrics();
+const auto p99 = metrics.total.queueWaitTime.percentile(0.99);
+
+ * Task identifiers are cheap handles of the pool internal objects, define EXT_THREAD_POOL_UUID_TASK_ID to add
+ * globally unique ext::uuid to each identifier(generating it costs some time on each task submission).
 */
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
 #include <future>
+#include <iterator>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <optional>
 #include <stdint.h>
+#include <string>
 #include <thread>
-#include <deque>
 #include <type_traits>
+#include <vector>
 
 #include <ext/core/check.h>
 #include <ext/core/noncopyable.h>
 
+#include <ext/details/thread_pool_details.h>
+
 #include <ext/reflection/enum.h>
 
 #include <ext/thread/event.h>
 #include <ext/thread/thread.h>
+#include <ext/thread/wait_group.h>
 
+#ifdef EXT_THREAD_POOL_UUID_TASK_ID
 #include <ext/types/uuid.h>
+#endif
 
 namespace ext {
 
@@ -47,17 +163,226 @@ namespace ext {
 class thread_pool : ext::NonCopyable
 {
 public:
-    using TaskId = ext::uuid;
+    // task identifier, handle of the pool task information object which is valid while the task is not done
+    struct TaskId
+    {
+        // index of the task information object in the pool
+        std::uint32_t index = std::numeric_limits<std::uint32_t>::max();
+        // count of the object reusing, makes identifiers of the finished tasks invalid
+        std::uint32_t generation = 0;
+#ifdef EXT_THREAD_POOL_UUID_TASK_ID
+        // globally unique task identifier
+        ext::uuid uuid;
+#endif
+
+        [[nodiscard]] bool operator==(const TaskId& other) const noexcept
+        { return index == other.index && generation == other.generation; }
+        [[nodiscard]] bool operator!=(const TaskId& other) const noexcept { return !(*this == other); }
+        [[nodiscard]] bool operator<(const TaskId& other) const noexcept
+        { return index < other.index || (index == other.index && generation < other.generation); }
+    };
+
+    // handle of the tasks added by one add_tasks call
+    class TasksBatch
+    {
+    public:
+        // wait till all tasks of the batch are executed or removed
+        void wait() const { m_waitGroup->wait(); }
+        // count of tasks in the batch
+        [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+    private:
+        friend thread_pool;
+        TasksBatch(std::shared_ptr<ext::WaitGroup> waitGroup, std::size_t size) noexcept
+            : m_waitGroup(std::move(waitGroup)), m_size(size)
+        {}
+
+        std::shared_ptr<ext::WaitGroup> m_waitGroup;
+        std::size_t m_size;
+    };
+
+    // task priority level, tasks with the higher level are executed first
+    typedef std::uint_fast32_t Priority;
+    // priority of the tasks added by add_task, add_high_priority_task uses the highest level
+    static constexpr Priority kNormalPriority = 0;
+    static constexpr std::uint_fast32_t kMaxPriorityLevelsCount = 64;
+
+    // error of the task future if the task deadline passed before the execution start
+    typedef thread_pool_details::deadline_exceeded deadline_exceeded;
+
+    // range of task indexes [0, size) for add_tasks, doesn't allocate memory for the elements
+    typedef thread_pool_details::index_range IndexRange;
+
+    // identifier of the fair share queue
+    typedef std::uint32_t QueueId;
+
+    // error of adding task to the full queue with the eReject overflow policy
+    typedef thread_pool_details::queue_overflow queue_overflow;
+
+    // behavior of adding tasks to the full bounded queue
+    enum class OverflowPolicy
+    {
+        eBlock,         // submitter waits for free places, pool workers execute their tasks in their threads
+        eReject,        // submitter gets queue_overflow exception
+        eCallerRuns,    // task is executed in the submitter thread, its deadline and metrics are handled as by workers
+        eDropOldest,    // the longest waiting queued task is removed, its future gets broken promise error
+    };
+
+    // thread pool settings
+    struct Options
+    {
+        // working threads count
+        std::uint_fast32_t threadsCount = ext::available_concurrency();
+        // each worker gets own tasks queue, normal priority tasks added from the worker thread are put into it.
+        // Idle workers steal tasks from the queues of other workers, execution order of such tasks is not guaranteed
+        bool workStealing = false;
+        // count of priority levels, from 1 to kMaxPriorityLevelsCount
+        std::uint_fast32_t priorityLevelsCount = 2;
+        // if not zero - tasks waiting longer than this time are executed before tasks with the higher priority
+        // in the order of adding, protects low priority tasks from starvation
+        std::chrono::steady_clock::duration agingTime = {};
+        // if greater than threadsCount - pool is elastic, threadsCount threads are always working and extra threads
+        // are started when tasks wait in the queue too long
+        std::uint_fast32_t maxThreadsCount = 0;
+        // elastic pool starts a new thread if queued task waits for execution longer than this time,
+        // next thread is started not earlier than this time after the previous one
+        std::chrono::steady_clock::duration spawnThreadLatency = std::chrono::milliseconds(50);
+        // elastic pool stops extra thread if it doesn't get tasks during this time
+        std::chrono::steady_clock::duration idleThreadTimeout = std::chrono::seconds(30);
+        // workers names prefix, worker index is appended to it, empty - workers are not named
+        std::string threadsName = {};
+        // cpus for pinning workers round-robin, empty - workers are not pinned
+        std::vector<unsigned> workersCpus = {};
+        // distribute workers over NUMA nodes round-robin and pin them to the node cpus, normal priority tasks
+        // added from the node workers are put into the node queue and executed by the node workers first
+        bool numaAware = false;
+        // cpus of each NUMA node, read from the system if empty
+        std::vector<std::vector<unsigned>> numaNodesCpus = {};
+        // collect runtime metrics, see get_metrics
+        bool collectMetrics = false;
+        // count of ext::thread_details::exponential_wait steps of the idle worker before sleeping, 0 - sleep at once.
+        // First 4 steps spin with pause instruction, next 4 steps yield, further steps sleep for 1 millisecond
+        std::uint_fast32_t idleSpinSteps = 0;
+        // tasks with deadline are put to the common queue and executed in the order of deadlines before other tasks
+        // of the same priority level, adding and taking of such task is logarithmic in count of queued deadline tasks
+        bool earliestDeadlineFirst = false;
+        // max count of queued tasks in all queues, 0 - queue is unbounded
+        std::size_t queueCapacity = 0;
+        // behavior of adding tasks to the full queue
+        OverflowPolicy overflowPolicy = OverflowPolicy::eBlock;
+        // count of extra worker slots for threads which replace workers blocked in ext::blocking_region,
+        // free slots of the elastic pool are also used for compensation
+        std::uint_fast32_t maxCompensatingThreadsCount = 0;
+        // if not zero - watchdog thread reports tasks running longer than this time by EXT_TRACE_ERR with the task
+        // identifier, the worker thread and the elapsed time, each task execution is reported once
+        std::chrono::steady_clock::duration hungTaskTimeout = {};
+        // watchdog interrupts the worker thread of the hung task, see ext::thread::interrupt
+        bool interruptHungTasks = false;
+    };
+
+    // histogram of durations with power of two microseconds buckets
+    struct DurationHistogram
+    {
+        static constexpr std::size_t kBucketsCount = 32;
+        // bucket 0 counts durations less than 1us, bucket i - durations in [2^(i-1), 2^i)us,
+        // the last bucket also counts all longer durations
+        std::array<std::uint64_t, kBucketsCount> buckets = {};
+
+        // count of durations in all buckets
+        [[nodiscard]] std::uint64_t count() const noexcept;
+        // upper bound of the bucket which contains the percentile, percentile is from 0 to 1
+        [[nodiscard]] std::chrono::microseconds percentile(double percentile) const noexcept;
+        // upper bound of the bucket durations
+        [[nodiscard]] static std::chrono::microseconds bucket_upper_bound(std::size_t bucket) noexcept;
+        // get bucket index for duration
+        [[nodiscard]] static std::size_t get_bucket(std::chrono::steady_clock::duration duration) noexcept;
+
+        DurationHistogram& operator+=(const DurationHistogram& other) noexcept;
+    };
+
+    // worker runtime counters
+    struct WorkerMetrics
+    {
+        // count of tasks added from the worker thread
+        std::uint64_t submittedTasksCount = 0;
+        std::uint64_t completedTasksCount = 0;
+        // count of tasks dropped because their deadline passed before the execution start
+        std::uint64_t expiredTasksCount = 0;
+        // count of tasks taken from the queues of other workers or NUMA nodes
+        std::uint64_t stolenTasksCount = 0;
+        // time of waiting for new tasks
+        std::chrono::nanoseconds idleTime = {};
+        // time between adding task to the queue and its execution start
+        DurationHistogram queueWaitTime;
+        DurationHistogram executionTime;
+
+        WorkerMetrics& operator+=(const WorkerMetrics& other) noexcept;
+    };
+
+    // snapshot of the pool runtime metrics
+    struct Metrics
+    {
+        // sum of all workers counters, also counts tasks added from other threads and tasks executed in them
+        // by the submitters with the eCallerRuns overflow policy
+        WorkerMetrics total;
+        // max count of simultaneously queued tasks
+        std::size_t queueDepthHighWaterMark = 0;
+        std::size_t queuedTasksCount = 0;
+        std::size_t runningTasksCount = 0;
+        // count of tasks reported by the watchdog as hung, counted without collectMetrics
+        std::uint64_t hungTasksCount = 0;
+        // counters of each worker, elastic pool reports all worker slots
+        std::vector<WorkerMetrics> workers;
+    };
+
+    // fair share queue statistics
+    struct QueueStats
+    {
+        std::string name;
+        std::uint32_t weight = 0;
+        // count of the queue tasks waiting for execution
+        std::size_t queuedTasksCount = 0;
+        // count of the queue tasks taken by workers
+        std::uint64_t startedTasksCount = 0;
+        // time between adding task to the queue and its execution start
+        DurationHistogram queueWaitTime;
+    };
+
+    // elastic pool threads management decisions
+    struct ThreadsCounters
+    {
+        // count of working threads
+        std::size_t threadsCount = 0;
+        // max count of simultaneously working threads
+        std::size_t peakThreadsCount = 0;
+        // count of threads started because of the queue latency
+        std::size_t spawnedThreadsCount = 0;
+        // count of threads stopped after idle timeout
+        std::size_t retiredThreadsCount = 0;
+        // count of times when queue latency exceeded the threshold or worker blocked but all threads were already working
+        std::size_t maxThreadsReachedCount = 0;
+        // count of workers inside ext::blocking_region
+        std::size_t blockedThreadsCount = 0;
+        // count of working threads started to replace blocked workers
+        std::size_t compensatingThreadsCount = 0;
+    };
 
     /**
      * \param onTaskDone callback on execution task by id
      * \param threadsCount working threads count
      */
     explicit thread_pool(std::function<void(const TaskId&)>&& onTaskDone,
-                         std::uint_fast32_t threadsCount = std::thread::hardware_concurrency());
-    thread_pool(std::uint_fast32_t threadsCount = std::thread::hardware_concurrency());
+                         std::uint_fast32_t threadsCount = ext::available_concurrency());
+    thread_pool(std::uint_fast32_t threadsCount = ext::available_concurrency());
+    /**
+     * \param options thread pool settings
+     * \param onTaskDone callback on execution task by id
+     */
+    explicit thread_pool(const Options& options, std::function<void(const TaskId&)>&& onTaskDone = nullptr);
 
     [[nodiscard]] static thread_pool& GlobalInstance();
+    // set options of the global instance, must be called before the first GlobalInstance call
+    static void ConfigureGlobalInstance(const Options& options);
 
     // interrupt and join all existing threads
     ~thread_pool();
@@ -65,6 +390,16 @@ public:
     // wait until task queue not empty
     void wait_for_tasks() const;
 
+    /**
+     * \brief Wait for the future of the task, pool worker executes queued tasks while waiting so recursive tasks
+     *        waiting for their subtasks don't block the pool. Other threads just wait for the future.
+     *        Interruption of the waiting task is received by the task executed by the worker at this moment
+     * \tparam Future std::future or std::shared_future
+     * \param future future of the awaited task
+     */
+    template <typename Future>
+    void wait(const Future& future);
+
     // detach and clear all working threads list, after calling this function class will be in inconsistent state
     void detach_all();
 
@@ -82,7 +417,22 @@ public:
                 std::invoke_result_t<Function, Args...>
               >>
         add_task(Function&& function, Args&&... args);
-    
+
+    /**
+     * \brief Try to add task function to the bounded queue, never waits and doesn't allocate if the queue is full
+     * \tparam Function to invoke
+     * \tparam Args list of arguments passed to function
+     * \param function execution function
+     * \param args list of arguments passed to function, not moved if the queue is full
+     * \return pair of a taskId(created task identifier) and a future(with task result), nullopt if the queue is full
+     */
+    template <typename Function, typename... Args>
+    std::optional<std::pair<TaskId,
+                            std::future<
+                              std::invoke_result_t<Function, Args...>
+                            >>>
+        try_add_task(Function&& function, Args&&... args);
+
     /**
      * \brief Add task function to queue with high priority
      * \tparam Function to invoke
@@ -98,285 +448,2421 @@ public:
               >>
         add_high_priority_task(Function&& function, Args&&... args);
 
-    // remove task from queue by id and interrupt if it is executing
-    // return true if task was removed or interrupted, false if task not found
-    bool stop_and_remove_task(const TaskId& taskId);
+    /**
+     * \brief Add task function to queue with priority
+     * \tparam Function to invoke
+     * \tparam Args list of arguments passed to function
+     * \param priority task priority level, less than Options::priorityLevelsCount
+     * \param function execution function
+     * \param args list of arguments passed to function
+     * \return pair of a taskId(created task identifier) and a future(with task result)
+     */
+    template <typename Function, typename... Args>
+    std::pair<TaskId,
+              std::future<
+                std::invoke_result_t<Function, Args...>
+              >>
+        add_task_with_priority(Priority priority, Function&& function, Args&&... args);
 
-    [[nodiscard]] std::size_t running_tasks_count() const noexcept;
+    /**
+     * \brief Add task function to queue with deadline, if the task is not started before the deadline
+     *        it is dropped and its future gets thread_pool::deadline_exceeded exception
+     * \tparam Function to invoke
+     * \tparam Args list of arguments passed to function
+     * \param deadline latest time of the task execution start
+     * \param function execution function
+     * \param args list of arguments passed to function
+     * \return pair of a taskId(created task identifier) and a future(with task result)
+     */
+    template <typename Function, typename... Args>
+    std::pair<TaskId,
+              std::future<
+                std::invoke_result_t<Function, Args...>
+              >>
+        add_task_with_deadline(std::chrono::steady_clock::time_point deadline, Function&& function, Args&&... args);
 
-    // interrupt and remove all tasks from queue
-    void interrupt_and_remove_all_tasks();
+    /**
+     * \brief Add fair share queue, queues are never removed
+     * \param name queue name reported in statistics
+     * \param weight count of tasks executed from the queue in its turn, the common queue has weight 1
+     * \return queue identifier
+     */
+    QueueId add_queue(std::string name, std::uint32_t weight = 1);
 
-private:
-    // main thread for workers
-    void worker(ext::thread& workerThread);
+    /**
+     * \brief Add task function to the fair share queue, tasks of the queue are executed in the order of adding
+     * \tparam Function to invoke
+     * \tparam Args list of arguments passed to function
+     * \param queue identifier returned by add_queue
+     * \param function execution function
+     * \param args list of arguments passed to function
+     * \return pair of a taskId(created task identifier) and a future(with task result)
+     */
+    template <typename Function, typename... Args>
+    std::pair<TaskId,
+              std::future<
+                std::invoke_result_t<Function, Args...>
+              >>
+        add_task_to_queue(QueueId queue, Function&& function, Args&&... args);
 
-    // task execution priority
-    enum class TaskPriority
-    {
-        eHigh,
-        eNormal,
-    };
+    // get statistics of the fair share queue
+    [[nodiscard]] QueueStats get_queue_stats(QueueId queue) const;
 
     /**
-     * \brief Add function to queue with high priority
+     * \brief Add task function to queue without creating a future, task exceptions are only traced.
+     *        If function with arguments is small enough, no memory allocations happen
      * \tparam Function to invoke
      * \tparam Args list of arguments passed to function
-     * \param priority task execution priority
      * \param function execution function
      * \param args list of arguments passed to function
-     * \return pair of a taskId(created task identifier) and a future(with task result)
-     */    
+     * \return created task identifier
+     */
     template <typename Function, typename... Args>
-    [[nodiscard]] std::pair<TaskId,
-              std::future<std::invoke_result_t<Function, Args...>>>
-        add_task_with_priority(TaskPriority priority, Function&& function, Args&&... args);
+    TaskId add_task_detached(Function&& function, Args&&... args);
+
+    /**
+     * \brief Add task for each range element to queue under one lock, task exceptions are only traced
+     * \tparam Range forward range, elements are moved to the tasks if range is rvalue.
+     *         Use IndexRange(count) to add count tasks getting their indexes
+     * \tparam Function to invoke with range element
+     * \param range tasks arguments
+     * \param function execution function, copied to each task
+     * \return handle for waiting of the batch tasks
+     */
+    template <typename Range, typename Function>
+    TasksBatch add_tasks(Range&& range, Function&& function);
+
+    /**
+     * \brief Add task for each range element to queue under one lock
+     * \tparam Range forward range, elements are moved to the tasks if range is rvalue
+     * \tparam Function to invoke with range element
+     * \param range tasks arguments
+     * \param function execution function, copied to each task
+     * \return futures with tasks results in the order of the range elements
+     */
+    template <typename Range, typename Function>
+    std::vector<std::future<std::invoke_result_t<std::decay_t<Function>,
+                                                 std::decay_t<thread_pool_details::range_reference_t<Range>>>>>
+        add_task_batch(Range&& range, Function&& function);
+
+    // remove task from queue by id and interrupt if it is executing, waits for the interrupted task end if waitInterrupted
+    // return true if task was removed or interrupted, false if task not found
+    bool stop_and_remove_task(const TaskId& taskId, bool waitInterrupted = true);
+
+    [[nodiscard]] std::size_t running_tasks_count() const noexcept;
+    // count of working threads
+    [[nodiscard]] std::size_t threads_count() const noexcept;
+    // get statistics of the elastic pool threads starting and stopping
+    [[nodiscard]] ThreadsCounters get_threads_counters() const noexcept;
+    // get snapshot of the runtime metrics, counters are zero if Options::collectMetrics is not set
+    [[nodiscard]] Metrics get_metrics() const;
+
+    // interrupt and remove all tasks from queue
+    void interrupt_and_remove_all_tasks();
 
 private:
+    friend class blocking_region;
+
     // struct with task information
     struct TaskInfo;
-    typedef std::unique_ptr<TaskInfo> TaskInfoPtr;
+    // returns task information to the pool for reusing
+    struct TaskInfoDeleter;
+    typedef std::unique_ptr<TaskInfo, TaskInfoDeleter> TaskInfoPtr;
+    typedef thread_pool_details::intrusive_list<TaskInfo> TasksList;
+    struct DeadlineOrder;
+    typedef thread_pool_details::intrusive_pairing_heap<TaskInfo, DeadlineOrder> DeadlineTasksHeap;
+    // tasks queue with own lock, base of the worker queue and the NUMA node queue
+    struct TasksQueue;
+    // worker thread with its own tasks queue
+    struct Worker;
+    // NUMA node with the queue of tasks added from the node workers
+    struct NumaNode;
+    // weighted queue of the normal priority tasks in the common queue
+    struct FairQueue;
+    // worker runtime counters, changed by the worker thread and read by metrics snapshots
+    struct MetricsCounters;
+
+    // task information object state
+    enum class TaskState
+    {
+        eFree,      // object is in the cache or task is being prepared
+        eQueued,    // task is in the common queue or in the worker queue
+        eRunning,   // task is executing by worker
+        eFinished,  // task is executed, object is going to be released
+    };
+
+    // main thread for workers
+    void worker(Worker& worker);
+    // execute popped task by worker and release it
+    void execute_task(Worker& worker, TaskInfoPtr&& taskToExecute);
+
+    // get next task for execution by worker and mark it as running, return nullptr if there are no tasks
+    [[nodiscard]] TaskInfoPtr pop_task(Worker& worker);
+    // get task from the common queue
+    [[nodiscard]] TaskInfoPtr pop_global_task(Worker& worker);
+    // get task from the worker own queue
+    [[nodiscard]] TaskInfoPtr pop_local_task(Worker& worker);
+    // get task from the worker NUMA node queue
+    [[nodiscard]] TaskInfoPtr pop_node_task(Worker& worker);
+    // steal task from the queue of another worker or another NUMA node
+    [[nodiscard]] TaskInfoPtr steal_task(Worker& thief);
+    // name worker thread and pin it to the cpus
+    void apply_worker_settings(Worker& worker);
+
+    // get task information object from the released objects cache or allocate a new one
+    [[nodiscard]] TaskInfoPtr acquire_task_info(Priority priority);
+    // get list of task information objects, takes the common cache lock only once
+    [[nodiscard]] TasksList acquire_task_infos(Priority priority, std::size_t count);
+    // allocate next chunk of task information objects and put them to m_freeTasks, called under m_freeTasksMutex
+    void allocate_tasks_chunk();
+    // get task information object by index from the task identifier, nullptr if there are no such object
+    [[nodiscard]] TaskInfo* find_task_info(std::uint32_t index) const noexcept;
+    // add task to the common queue of its priority level or to its fair share queue, called under m_taskQueueMutex
+    void push_global_task(TaskInfo* taskInfo) noexcept;
+    // remove task from the common queue, called under m_taskQueueMutex
+    void erase_global_task(TaskInfo* taskInfo) noexcept;
+    // pop task of the level from the common queue, tasks with deadline first, called under m_taskQueueMutex
+    [[nodiscard]] TaskInfo* pop_global_level_task(Priority level) noexcept;
+    // task is ordered by deadline in the common queue
+    [[nodiscard]] bool is_ordered_by_deadline(const TaskInfo& taskInfo) const noexcept;
+    // get level of the next executing task from the common queue, called under m_taskQueueMutex
+    [[nodiscard]] Priority get_next_global_task_level() const noexcept;
+    // check that the common queue has no tasks of the level, called under m_taskQueueMutex
+    [[nodiscard]] bool is_global_level_empty(Priority level) const noexcept;
+    // get enqueue time of the oldest task of the not empty level, called under m_taskQueueMutex
+    [[nodiscard]] std::chrono::steady_clock::time_point get_global_level_oldest_time(Priority level) const noexcept;
+    // get the oldest task of the common queue level and of its fair share queues, called under m_taskQueueMutex
+    [[nodiscard]] TaskInfo* get_global_level_oldest_task(Priority level) const noexcept;
+    // pop normal priority task from the common queue or the fair share queues, called under m_taskQueueMutex
+    [[nodiscard]] TaskInfo* pop_fair_share_task() noexcept;
+    // move all tasks from the common queue and fair share queues to the removed tasks, called under m_taskQueueMutex
+    void take_global_tasks(TasksList& removedTasks) noexcept;
+    // mark popped task as executing by worker, called under the lock of the queue
+    [[nodiscard]] TaskInfoPtr start_task(TaskInfo* taskInfo, Worker& worker) noexcept;
+    // move all tasks from the queue to the removed tasks list, called under the lock of the queue
+    void take_queued_tasks(TasksList& queue, TasksList& removedTasks) noexcept;
+    // destroy task function and put task information object to the cache
+    void release_task_info(TaskInfo* taskInfo) noexcept;
+    // release all tasks from list
+    void release_tasks(TasksList& tasks) noexcept;
+
+    // put task to the queue and wake up worker, return task id. If the queue place is not reserved
+    // the overflow policy is applied
+    TaskId enqueue_task(TaskInfoPtr&& taskInfo, bool placeReserved = false);
+    // put normal priority tasks to the queue under one lock and wake up workers for them
+    void enqueue_tasks(TasksList& tasks);
+    // execute task in the current thread instead of adding it to the queue, return task id.
+    // Expired task is not called and metrics are collected the same way as for the queued tasks
+    TaskId execute_in_caller_thread(TaskInfoPtr&& taskInfo);
+
+    // reserve places in the bounded queue applying the overflow policy,
+    // return false if tasks must be executed in the caller thread
+    [[nodiscard]] bool reserve_queue_places(std::size_t count);
+    // reserve places in the bounded queue if there are enough free places
+    [[nodiscard]] bool try_reserve_queue_places(std::size_t count) noexcept;
+    // free places of the tasks which left the bounded queue and wake up blocked submitters
+    void release_queue_places(std::size_t count) noexcept;
+    // remove the longest waiting task from the queues, return false if there are no queued tasks.
+    // Queues are checked one by one, so the task is the oldest one only among tasks which are not taken meanwhile
+    bool drop_oldest_task();
+    // create task for each range element by calling createTask(TaskInfo&, element)
+    template <typename Range, typename CreateTask>
+    [[nodiscard]] TasksList create_tasks(Range&& range, CreateTask&& createTask);
+
+    // elastic pool thread, starts new workers while queued tasks wait longer than m_spawnThreadLatency
+    void elastic_monitor();
+    // wake up elastic monitor waiting for tasks
+    void notify_elastic_monitor();
+    // get enqueue time of the oldest queued task, called under m_taskQueueMutex
+    [[nodiscard]] std::chrono::steady_clock::time_point get_oldest_queued_task_time() noexcept;
+    // start worker thread in the free slot of the elastic pool if it is allowed by limits
+    void try_spawn_worker();
+    // start thread in the free worker slot, called under m_workersMutex, return false if there are no free slots.
+    // Compensating worker replaces the blocked one and retires after the blocking regions end
+    [[nodiscard]] bool start_worker(bool compensating = false);
+    // stop idle worker if there are more working threads than minimum, called under m_taskQueueMutex
+    [[nodiscard]] bool try_retire_worker(Worker& worker);
+    // stop idle worker if blocked workers it replaced are unblocked, called under m_taskQueueMutex
+    [[nodiscard]] bool try_retire_compensating_worker(Worker& worker);
+    // worker of the pool entered the blocking region, start compensating worker
+    void on_worker_blocking();
+    // worker of the pool left the blocking region, wake up idle workers to retire the compensating one
+    void on_worker_unblocked();
+    // watchdog thread, reports tasks running longer than m_hungTaskTimeout
+    void watchdog();
+    // check that active workers threads are working, used for debug assertions
+    [[nodiscard]] bool has_working_threads();
+
+    // count submitted tasks and update queue depth high water mark, used only if metrics are collected
+    void on_tasks_submitted(std::size_t count) noexcept;
+
+    // spin waiting for tasks before sleeping, return true if tasks appeared
+    [[nodiscard]] bool spin_wait_for_tasks() noexcept;
+    // take count of spinning workers which will take new tasks without notification, return taken count
+    [[nodiscard]] std::size_t claim_spinning_workers(std::size_t count) noexcept;
+
+    // wake up sleeping workers, used when tasks added without locking the common queue
+    void notify_sleeping_workers(std::size_t count = 1);
+    // wake up threads waiting in wait_for_tasks or stop_and_remove_task
+    void notify_task_done();
+
+    // get worker of this pool which is executing in the current thread, nullptr if current thread is not a worker
+    [[nodiscard]] Worker* get_current_worker() const noexcept;
+    // get queue for the normal priority tasks added from the current thread, nullptr for the common queue
+    [[nodiscard]] TasksQueue* get_current_thread_queue() const noexcept;
+    [[nodiscard]] static Worker*& current_thread_worker() noexcept;
+
+    // options of the global instance set before its creation
+    struct GlobalInstanceSettings
+    {
+        std::mutex mutex;
+        std::optional<Options> options;
+        bool created = false;
+    };
+    [[nodiscard]] static GlobalInstanceSettings& global_instance_settings() noexcept;
 
-    // synchronization of m_queueTasks
+private:
+    // worker checks the common queue before own queue on every N task to avoid common queue starvation
+    static constexpr std::uint_fast32_t kGlobalQueueCheckInterval = 61;
+    // max count of released tasks cached by worker, the half of them are moved to m_freeTasks on overflow
+    static constexpr std::size_t kMaxWorkerFreeTasks = 256;
+    // size of the first task information objects chunk, each next chunk is twice bigger than the previous one
+    static constexpr std::uint32_t kFirstTasksChunkSizeLog = 6;
+    // count of chunks enough to address all task indexes
+    static constexpr std::size_t kMaxTasksChunksCount = 32 - kFirstTasksChunkSizeLog;
+    // min interval of the elastic pool queue latency checks
+    static constexpr std::chrono::milliseconds kMinElasticCheckInterval = std::chrono::milliseconds(1);
+    // intervals of the future checks by the worker waiting for it without tasks to execute
+    static constexpr std::chrono::microseconds kMinHelpingWaitInterval = std::chrono::microseconds(1);
+    static constexpr std::chrono::microseconds kMaxHelpingWaitInterval = std::chrono::milliseconds(1);
+    // min interval of the watchdog checks, watchdog checks running tasks 4 times per hung task timeout
+    static constexpr std::chrono::milliseconds kMinWatchdogCheckInterval = std::chrono::milliseconds(1);
+
+    // synchronization of m_priorityQueues
     mutable std::mutex m_taskQueueMutex;
     std::condition_variable m_taskQueueChangedNotifier;
     mutable std::condition_variable m_allTasksDoneCv;
 
-    // queue of tasks ordered by TaskPriority
-    std::deque<TaskInfoPtr> m_queueTasks;
+    // common queue, FIFO of tasks for each priority level
+    std::vector<TasksList> m_priorityQueues;
+    // tasks of the common queue levels ordered by deadline, they are also kept in the level FIFO.
+    // Empty if pool doesn't use earliest deadline first order
+    std::vector<DeadlineTasksHeap> m_deadlineQueues;
+    // adding order of the deadline tasks, orders tasks with the same deadline
+    std::uint64_t m_deadlineTasksSequence = 0;
+    // bit mask of the not empty priority levels, normal level also includes fair share queues tasks
+    std::uint64_t m_notEmptyLevels = 0;
+    // fair share queues, the deque keeps queues addresses on adding
+    std::deque<FairQueue> m_fairQueues;
+    // count of added fair share queues, used for identifiers checks without lock
+    std::atomic<QueueId> m_fairQueuesCount = 0;
+    // count of tasks in the fair share queues
+    std::size_t m_fairQueuedTasksCount = 0;
+    // turn of the fair share queues round, 0 - turn of the common queue, i - turn of the queue with identifier i - 1
+    std::size_t m_fairShareTurn = 0;
+    // count of tasks which might be taken from the queue in the current turn
+    std::uint32_t m_fairShareTurnTasksLeft = 0;
+    // tasks waiting longer are executed first, aging is disabled if zero
+    const std::chrono::steady_clock::duration m_agingTime;
+
+    // cache of released tasks information objects
+    std::mutex m_freeTasksMutex;
+    TasksList m_freeTasks;
+    // task information objects storage, objects are never deallocated till the pool destruction
+    // so task identifier index always points to the valid object
+    std::array<std::atomic<TaskInfo*>, kMaxTasksChunksCount> m_tasksChunks = {};
+    // count of allocated chunks, changed under m_freeTasksMutex
+    std::size_t m_tasksChunksCount = 0;
 
     // callback to callers about task done
     const std::function<void(const TaskId&)> m_onTaskDone;
 
-    // list of worker threads
-    std::vector<ext::thread> m_threads;
-    std::unordered_map<TaskId, ext::thread*> m_runningTasks;
+    // workers own queues usage flag
+    const bool m_workStealing;
+
+    // count of tasks in all queues
+    std::atomic_size_t m_queuedTasksCount = 0;
+    // max count of queued tasks, 0 if the queue is unbounded
+    const std::size_t m_queueCapacity;
+    const OverflowPolicy m_overflowPolicy;
+    // count of the bounded queue places taken by queued tasks and tasks being added
+    std::atomic_size_t m_queuePlacesUsed = 0;
+    // synchronization of the submitters waiting for free places
+    std::mutex m_queuePlacesMutex;
+    std::condition_variable m_queuePlacesCv;
+    std::atomic_size_t m_queuePlacesWaitersCount = 0;
+    // count of tasks which are executing now
+    std::atomic_size_t m_runningTasksCount = 0;
+    // count of workers waiting for new tasks
+    std::atomic_size_t m_sleepingWorkersCount = 0;
+    // count of spinning workers not claimed by submitters yet, approximate: worker might finish spinning
+    // while the submitter claims it, but such worker checks queued tasks before sleeping
+    std::atomic_size_t m_spinningWorkersCount = 0;
+    // count of exponential wait steps before sleeping
+    const std::uint_fast32_t m_idleSpinSteps;
+    // count of threads waiting on m_allTasksDoneCv
+    mutable std::atomic_size_t m_tasksDoneWaitersCount = 0;
+
+    // workers placement settings
+    const std::string m_threadsName;
+    const std::vector<unsigned> m_workersCpus;
+    // NUMA nodes queues, empty if pool is not NUMA aware
+    std::vector<NumaNode> m_numaNodes;
+
+    // list of worker threads, elastic pool has slots for max threads count and only part of them are active
+    std::vector<Worker> m_workers;
     std::atomic_bool m_threadPoolWorks = true;
+
+    // count of always working threads
+    const std::size_t m_minThreadsCount;
+    // pool starts and stops threads if max threads count is greater than minimum
+    const bool m_elastic;
+    const std::chrono::steady_clock::duration m_spawnThreadLatency;
+    const std::chrono::steady_clock::duration m_idleThreadTimeout;
+    // runtime metrics collection flag
+    const bool m_collectMetrics;
+    // count of tasks added from the threads which are not workers
+    std::atomic_uint64_t m_externalSubmittedTasksCount = 0;
+    // counters of the tasks executed by the submitters which are not workers, their queue wait time is zero
+    std::atomic_uint64_t m_externalCompletedTasksCount = 0;
+    std::atomic_uint64_t m_externalExpiredTasksCount = 0;
+    std::array<std::atomic_uint64_t, DurationHistogram::kBucketsCount> m_externalExecutionTime = {};
+    std::atomic_size_t m_queueDepthHighWaterMark = 0;
+    // tasks enqueue time is used by aging, by the elastic pool, by metrics and by dropping the oldest tasks
+    const bool m_stampEnqueueTime;
+    // tasks with deadline are ordered by it in the common queue
+    const bool m_earliestDeadlineFirst;
+
+    // synchronization of the workers activity and m_threadsCounters, locked after m_taskQueueMutex
+    mutable std::mutex m_workersMutex;
+    // count of working threads
+    std::atomic_size_t m_activeWorkersCount = 0;
+    // max count of working threads without compensating ones
+    const std::size_t m_maxThreadsCount;
+    // count of workers in blocking regions and count of threads started to replace them, changed under m_workersMutex
+    std::atomic_size_t m_blockedWorkersCount = 0;
+    std::atomic_size_t m_compensatingWorkersCount = 0;
+    ThreadsCounters m_threadsCounters;
+    std::chrono::steady_clock::time_point m_lastSpawnTime;
+
+    // thread which checks queue latency in the elastic pool
+    std::thread m_elasticMonitor;
+    std::condition_variable m_elasticMonitorCv;
+    // monitor waits for tasks adding
+    std::atomic_bool m_elasticMonitorIdle = false;
+
+    // watchdog is enabled if the timeout is not zero
+    const std::chrono::steady_clock::duration m_hungTaskTimeout;
+    const bool m_interruptHungTasks;
+    std::atomic_uint64_t m_hungTasksCount = 0;
+    std::thread m_watchdog;
+    // synchronization of the watchdog stop
+    std::mutex m_watchdogMutex;
+    std::condition_variable m_watchdogCv;
 };
 
-// struct with task information
-struct thread_pool::TaskInfo : ext::NonCopyable
+// Marks that the current thread pool worker is going to block, the pool starts a compensating worker for the region
+// time if it has free worker slots. Regions might be nested, does nothing in threads which are not pool workers
+class blocking_region : ext::NonCopyable
 {
-    explicit TaskInfo(TaskId id, const TaskPriority _priority, std::function<void()>&& _task) noexcept
-        : task(std::move(_task)), priority(_priority), taskId(std::move(id))
-    {}
+public:
+    blocking_region();
+    ~blocking_region();
+
+private:
+    thread_pool::Worker* m_worker = nullptr;
+};
 
+// struct with task information, objects are reused for different tasks
+struct thread_pool::TaskInfo : ext::NonCopyable
+{
+    TaskInfo() noexcept = default;
     TaskInfo(const TaskInfo&) = delete;
     TaskInfo(TaskInfo&&) = delete;
 
-    const std::function<void()> task;
-    const TaskPriority priority;
-    const TaskId taskId;
+    [[nodiscard]] TaskId get_id() const noexcept
+    {
+#ifdef EXT_THREAD_POOL_UUID_TASK_ID
+        return TaskId{ index, generation, uuid };
+#else
+        return TaskId{ index, generation };
+#endif
+    }
+
+    thread_pool_details::task_function task;
+    Priority priority = kNormalPriority;
+    // time of adding to the queue, used only if aging is enabled or pool is elastic
+    std::chrono::steady_clock::time_point enqueueTime;
+    // latest time of the execution start, max if task has no deadline
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    // task deadline passed, set by the worker before the task call
+    bool expired = false;
+    // fair share queue of the task, kNoFairQueue if task is not in such queue
+    static constexpr QueueId kNoFairQueue = std::numeric_limits<QueueId>::max();
+    QueueId fairQueue = kNoFairQueue;
+
+    // position of the object in the pool storage
+    std::uint32_t index = 0;
+    // incremented on each object release
+    std::atomic_uint32_t generation = 0;
+    std::atomic<TaskState> state = TaskState::eFree;
+    // queue of the queued task(nullptr for the common queue), changed together with state under the queue lock
+    std::atomic<TasksQueue*> queue = nullptr;
+    // worker which executes the running task, changed together with state under the worker lock
+    std::atomic<Worker*> worker = nullptr;
+#ifdef EXT_THREAD_POOL_UUID_TASK_ID
+    ext::uuid uuid;
+#endif
+
+    // links in a tasks list
+    TaskInfo* next = nullptr;
+    TaskInfo* prev = nullptr;
+    // links in the deadline tasks heap and the adding order of the task, used by earliest deadline first order
+    TaskInfo* heapChild = nullptr;
+    TaskInfo* heapNext = nullptr;
+    TaskInfo* heapPrev = nullptr;
+    std::uint64_t deadlineSequence = 0;
+};
+
+// order of the deadline tasks execution, tasks with the same deadline are executed in the adding order
+struct thread_pool::DeadlineOrder
+{
+    [[nodiscard]] bool operator()(const TaskInfo& first, const TaskInfo& second) const noexcept
+    {
+        return first.deadline < second.deadline ||
+            (first.deadline == second.deadline && first.deadlineSequence < second.deadlineSequence);
+    }
+};
+
+struct thread_pool::TaskInfoDeleter
+{
+    void operator()(TaskInfo* taskInfo) const noexcept { pool->release_task_info(taskInfo); }
+
+    thread_pool* pool;
+};
+
+// tasks queue with own lock
+struct thread_pool::TasksQueue : ext::NonCopyable
+{
+    // synchronization of tasks, worker also protects the executing task state by it
+    std::mutex mutex;
+    TasksList tasks;
+};
+
+// worker runtime counters, only the worker thread changes them so increments don't need atomic read-modify-write
+struct alignas(64) thread_pool::MetricsCounters
+{
+    std::atomic_uint64_t submittedTasksCount = 0;
+    std::atomic_uint64_t completedTasksCount = 0;
+    std::atomic_uint64_t expiredTasksCount = 0;
+    std::atomic_uint64_t stolenTasksCount = 0;
+    std::atomic_int64_t idleTimeNs = 0;
+    std::array<std::atomic_uint64_t, DurationHistogram::kBucketsCount> queueWaitTime = {};
+    std::array<std::atomic_uint64_t, DurationHistogram::kBucketsCount> executionTime = {};
+
+    template <typename Integer>
+    static void increase(std::atomic<Integer>& counter, Integer value = 1) noexcept
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    void add_duration(std::array<std::atomic_uint64_t, DurationHistogram::kBucketsCount>& histogram,
+                      std::chrono::steady_clock::duration duration) noexcept
+    {
+        increase<std::uint64_t>(histogram[DurationHistogram::get_bucket(duration)]);
+    }
+
+    [[nodiscard]] WorkerMetrics get_metrics() const noexcept
+    {
+        WorkerMetrics metrics;
+        metrics.submittedTasksCount = submittedTasksCount.load(std::memory_order_relaxed);
+        metrics.completedTasksCount = completedTasksCount.load(std::memory_order_relaxed);
+        metrics.expiredTasksCount = expiredTasksCount.load(std::memory_order_relaxed);
+        metrics.stolenTasksCount = stolenTasksCount.load(std::memory_order_relaxed);
+        metrics.idleTime = std::chrono::nanoseconds(idleTimeNs.load(std::memory_order_relaxed));
+        for (std::size_t i = 0; i < DurationHistogram::kBucketsCount; ++i)
+        {
+            metrics.queueWaitTime.buckets[i] = queueWaitTime[i].load(std::memory_order_relaxed);
+            metrics.executionTime.buckets[i] = executionTime[i].load(std::memory_order_relaxed);
+        }
+        return metrics;
+    }
+};
+
+// worker thread with its own tasks queue, the queue is used only in the work stealing mode
+struct thread_pool::Worker : TasksQueue
+{
+    thread_pool* pool = nullptr;
+    ext::thread thread;
+    // NUMA node of the worker, nullptr if pool is not NUMA aware
+    NumaNode* node = nullptr;
+
+    // released tasks cache, accessed only from the worker thread
+    TasksList freeTasks;
+    // count of tasks taken by the worker
+    std::uint_fast32_t popsCount = 0;
+    // worker thread is started and not retired, changed under m_workersMutex
+    bool active = false;
+    // worker thread was started to replace the blocked worker, only such workers retire after the blocking regions end.
+    // Set under m_workersMutex before the thread start and reset by the worker thread itself
+    bool compensating = false;
+    // runtime counters, changed only if metrics are collected
+    MetricsCounters metrics;
+    // count of nested blocking regions of the worker thread, accessed only from the worker thread
+    std::size_t blockingRegionsCount = 0;
+    // task executing by the worker and its start time, set only if the watchdog is enabled, changed under mutex.
+    // Worker waiting for the future executes nested tasks, the waiting task is restored after them
+    TaskInfo* watchedTask = nullptr;
+    std::chrono::steady_clock::time_point watchedTaskStartTime;
+    // watched task was reported by the watchdog
+    bool watchedTaskReported = false;
+};
+
+// NUMA node with the queue of tasks added from the node workers
+struct thread_pool::NumaNode : TasksQueue
+{
+    // node workers are pinned to these cpus
+    std::vector<unsigned> cpus;
+};
+
+// weighted queue of the normal priority tasks, protected by m_taskQueueMutex
+struct thread_pool::FairQueue : ext::NonCopyable
+{
+    FairQueue(std::string name, std::uint32_t weight) noexcept : name(std::move(name)), weight(weight) {}
+
+    const std::string name;
+    // count of tasks executed from the queue in its turn
+    const std::uint32_t weight;
+    TasksList tasks;
+    std::uint64_t startedTasksCount = 0;
+    DurationHistogram queueWaitTime;
 };
 
 inline thread_pool& thread_pool::GlobalInstance()
 {
-    static thread_pool globalThreadPool;
+    static thread_pool globalThreadPool([]()
+    {
+        GlobalInstanceSettings& settings = global_instance_settings();
+        std::lock_guard lock(settings.mutex);
+        settings.created = true;
+        return settings.options.value_or(Options{});
+    }());
     return globalThreadPool;
 }
 
+inline void thread_pool::ConfigureGlobalInstance(const Options& options)
+{
+    GlobalInstanceSettings& settings = global_instance_settings();
+    std::lock_guard lock(settings.mutex);
+    EXT_CHECK(!settings.created) << "Global thread pool is already created";
+    settings.options = options;
+}
+
 template <typename Function, typename... Args>
-std::pair<thread_pool::TaskId, 
+std::pair<thread_pool::TaskId,
           std::future<
             std::invoke_result_t<Function, Args...>
             >>
     thread_pool::add_task(Function&& function, Args&&... args)
 {
-    return add_task_with_priority(TaskPriority::eNormal, std::forward<Function>(function), std::forward<Args>(args)...);
+    return add_task_with_priority(kNormalPriority, std::forward<Function>(function), std::forward<Args>(args)...);
+}
+
+template <typename Future>
+void thread_pool::wait(const Future& future)
+{
+    Worker* worker = get_current_worker();
+    if (worker == nullptr)
+    {
+        future.wait();
+        return;
+    }
+
+    // awaited task might be executed by another worker, poll it between tasks and wait for it while there is no work
+    std::chrono::microseconds idleWait = kMinHelpingWaitInterval;
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+        if (TaskInfoPtr task = pop_task(*worker))
+        {
+            execute_task(*worker, std::move(task));
+            idleWait = kMinHelpingWaitInterval;
+            continue;
+        }
+
+        future.wait_for(idleWait);
+        idleWait = std::min(idleWait * 2, kMaxHelpingWaitInterval);
+    }
+}
+
+template <typename Function, typename... Args>
+std::optional<std::pair<thread_pool::TaskId,
+                        std::future<
+                          std::invoke_result_t<Function, Args...>
+                        >>>
+    thread_pool::try_add_task(Function&& function, Args&&... args)
+{
+    if (m_queueCapacity != 0 && !try_reserve_queue_places(1))
+        return std::nullopt;
+
+    using _Result = std::invoke_result_t<Function, Args...>;
+    using Task = thread_pool_details::promise_task<_Result, Function, Args...>;
+
+    TaskInfoPtr taskInfo(nullptr, TaskInfoDeleter{ this });
+    std::future<_Result> resultFuture;
+    try
+    {
+        taskInfo = acquire_task_info(kNormalPriority);
+        resultFuture = taskInfo->task.emplace<Task>(std::forward<Function>(function), std::forward<Args>(args)...).get_future();
+    }
+    catch (...)
+    {
+        if (m_queueCapacity != 0)
+            release_queue_places(1);
+        throw;
+    }
+
+    return std::make_pair(enqueue_task(std::move(taskInfo), true), std::move(resultFuture));
 }
 
 template <typename Function, typename... Args>
-std::pair<thread_pool::TaskId, 
+std::pair<thread_pool::TaskId,
           std::future<
             std::invoke_result_t<Function, Args...>
             >>
     thread_pool::add_high_priority_task(Function&& function, Args&&... args)
 {
-    return add_task_with_priority(TaskPriority::eHigh, std::forward<Function>(function), std::forward<Args>(args)...);
+    return add_task_with_priority(static_cast<Priority>(m_priorityQueues.size() - 1),
+                                  std::forward<Function>(function), std::forward<Args>(args)...);
 }
 
 template <typename Function, typename... Args>
-std::pair<thread_pool::TaskId, 
+std::pair<thread_pool::TaskId,
           std::future<
             std::invoke_result_t<Function, Args...>
             >>
-    thread_pool::add_task_with_priority(TaskPriority priority, Function&& function, Args&&... args)
+    thread_pool::add_task_with_priority(Priority priority, Function&& function, Args&&... args)
 {
+    EXT_CHECK(priority < m_priorityQueues.size()) << "Unknown priority level " << priority;
+
     using _Result = std::invoke_result_t<Function, Args...>;
-    using PackagedTaskPtr = std::unique_ptr<std::packaged_task<_Result()>>;
+    using Task = thread_pool_details::promise_task<_Result, Function, Args...>;
 
-    // packaging task with params
-    PackagedTaskPtr packagedTask = std::make_unique<std::packaged_task<_Result()>>(
-            ext::ThreadInvoker<Function, Args...>(
-                std::forward<Function>(function), std::forward<Args>(args)...)
-            );
-    std::future<_Result> resultFuture = packagedTask->get_future();
+    // constructing task with params directly in the task information object, avoid extra arguments moving
+    TaskInfoPtr taskInfo = acquire_task_info(priority);
+    std::future<_Result> resultFuture = taskInfo->task.emplace<Task>(
+        std::forward<Function>(function), std::forward<Args>(args)...).get_future();
 
-    // adding task to a queue
-    TaskId taskId;
-    {
-        auto taskInfo = std::make_unique<TaskInfo>(taskId, priority,
-            [taskPointer = packagedTask.release()]()
-            {
-                PackagedTaskPtr taskPtr(taskPointer);
-                taskPtr->operator()();
-            });
+    return std::make_pair(enqueue_task(std::move(taskInfo)), std::move(resultFuture));
+}
 
-        std::lock_guard<std::mutex> lock(m_taskQueueMutex);
-        switch (priority)
-        {
-        case TaskPriority::eHigh:
-        {
-            const auto priorityIt = std::find_if(m_queueTasks.cbegin(), m_queueTasks.cend(),
-                [priority](const TaskInfoPtr& task)
-                {
-                    return task->priority > priority;
-                });   
-            m_queueTasks.emplace(priorityIt, std::move(taskInfo));
-            break;
-        }
-        case TaskPriority::eNormal:
-            m_queueTasks.emplace_back(std::move(taskInfo));
-            break;
-        default:
-            static_assert(ext::reflection::get_enum_size<TaskPriority>() == 2, 
-                "Task priority has unsupported value, extent this enum");
-            EXT_UNREACHABLE();
-        }
-        m_taskQueueChangedNotifier.notify_one();
-    }
+template <typename Function, typename... Args>
+std::pair<thread_pool::TaskId,
+          std::future<
+            std::invoke_result_t<Function, Args...>
+            >>
+    thread_pool::add_task_with_deadline(std::chrono::steady_clock::time_point deadline, Function&& function, Args&&... args)
+{
+    using _Result = std::invoke_result_t<Function, Args...>;
+    using Task = thread_pool_details::deadline_task<_Result, Function, Args...>;
 
-    EXT_ASSERT(std::any_of(m_threads.begin(), m_threads.end(), std::mem_fn(&ext::thread::thread_works)))
-        << "Threads interrupted or stopped";
+    TaskInfoPtr taskInfo = acquire_task_info(kNormalPriority);
+    taskInfo->deadline = deadline;
+    std::future<_Result> resultFuture = taskInfo->task.emplace<Task>(
+        taskInfo->expired, std::forward<Function>(function), std::forward<Args>(args)...).get_future();
 
-    return std::make_pair(std::move(taskId), std::move(resultFuture));
+    return std::make_pair(enqueue_task(std::move(taskInfo)), std::move(resultFuture));
 }
 
-inline bool thread_pool::stop_and_remove_task(const TaskId& taskId)
+template <typename Function, typename... Args>
+std::pair<thread_pool::TaskId,
+          std::future<
+            std::invoke_result_t<Function, Args...>
+            >>
+    thread_pool::add_task_to_queue(QueueId queue, Function&& function, Args&&... args)
 {
-    ext::thread* threadToInterrupt = nullptr;
+    EXT_CHECK(queue < m_fairQueuesCount) << "Unknown queue " << queue;
 
-    {
-        std::lock_guard lock(m_taskQueueMutex);
+    using _Result = std::invoke_result_t<Function, Args...>;
+    using Task = thread_pool_details::promise_task<_Result, Function, Args...>;
 
-        auto it = std::find_if(m_queueTasks.begin(), m_queueTasks.end(),
-            [&](const TaskInfoPtr& task) {
-                return task->taskId == taskId;
-            });
-        if (it != m_queueTasks.end())
-        {
-            m_queueTasks.erase(it);
-            return true;
+    TaskInfoPtr taskInfo = acquire_task_info(kNormalPriority);
+    taskInfo->fairQueue = queue;
+    std::future<_Result> resultFuture = taskInfo->task.emplace<Task>(
+        std::forward<Function>(function), std::forward<Args>(args)...).get_future();
+
+    return std::make_pair(enqueue_task(std::move(taskInfo)), std::move(resultFuture));
+}
+
+template <typename Function, typename... Args>
+thread_pool::TaskId thread_pool::add_task_detached(Function&& function, Args&&... args)
+{
+    using Task = thread_pool_details::detached_task<Function, Args...>;
+
+    TaskInfoPtr taskInfo = acquire_task_info(kNormalPriority);
+    taskInfo->task.emplace<Task>(std::forward<Function>(function), std::forward<Args>(args)...);
+    return enqueue_task(std::move(taskInfo));
+}
+
+template <typename Range, typename Function>
+thread_pool::TasksBatch thread_pool::add_tasks(Range&& range, Function&& function)
+{
+    using Task = thread_pool_details::batch_task<Function&, thread_pool_details::range_reference_t<Range>>;
+
+    auto waitGroup = std::make_shared<ext::WaitGroup>();
+    TasksList tasks = create_tasks(std::forward<Range>(range), [&](TaskInfo& taskInfo, auto&& element)
+    {
+        taskInfo.task.emplace<Task>(waitGroup, function, std::forward<decltype(element)>(element));
+    });
+
+    TasksBatch batch(std::move(waitGroup), tasks.size());
+    enqueue_tasks(tasks);
+    return batch;
+}
+
+template <typename Range, typename Function>
+std::vector<std::future<std::invoke_result_t<std::decay_t<Function>,
+                                             std::decay_t<thread_pool_details::range_reference_t<Range>>>>>
+    thread_pool::add_task_batch(Range&& range, Function&& function)
+{
+    using Element = thread_pool_details::range_reference_t<Range>;
+    using _Result = std::invoke_result_t<std::decay_t<Function>, std::decay_t<Element>>;
+    using Task = thread_pool_details::promise_task<_Result, Function&, Element>;
+
+    std::vector<std::future<_Result>> futures;
+    TasksList tasks = create_tasks(std::forward<Range>(range), [&](TaskInfo& taskInfo, auto&& element)
+    {
+        futures.emplace_back(taskInfo.task.emplace<Task>(
+            function, std::forward<decltype(element)>(element)).get_future());
+    });
+
+    enqueue_tasks(tasks);
+    return futures;
+}
+
+template <typename Range, typename CreateTask>
+thread_pool::TasksList thread_pool::create_tasks(Range&& range, CreateTask&& createTask)
+{
+    TasksList tasks = acquire_task_infos(kNormalPriority,
+                                         static_cast<std::size_t>(std::distance(std::begin(range), std::end(range))));
+    try
+    {
+        TaskInfo* taskInfo = tasks.front();
+        for (auto&& element : range)
+        {
+            if constexpr (std::is_lvalue_reference_v<Range>)
+                createTask(*taskInfo, element);
+            else
+                createTask(*taskInfo, std::move(element));
+            taskInfo = taskInfo->next;
+        }
+    }
+    catch (...)
+    {
+        release_tasks(tasks);
+        throw;
+    }
+    return tasks;
+}
+
+inline void thread_pool::enqueue_tasks(TasksList& tasks)
+{
+    const std::size_t count = tasks.size();
+    if (count == 0)
+        return;
+
+    bool placesReserved = true;
+    try
+    {
+        placesReserved = reserve_queue_places(count);
+    }
+    catch (...)
+    {
+        release_tasks(tasks);
+        throw;
+    }
+    if (!placesReserved)
+    {
+        while (TaskInfo* taskInfo = tasks.pop_front())
+        {
+            execute_in_caller_thread(TaskInfoPtr(taskInfo, TaskInfoDeleter{ this }));
+        }
+        return;
+    }
+
+    TasksQueue* queue = get_current_thread_queue();
+    const auto enqueueTime = m_stampEnqueueTime ?
+        std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    // tasks identifiers are not returned yet so nobody can access tasks, mark them as queued without lock
+    for (TaskInfo* taskInfo = tasks.front(); taskInfo != nullptr; taskInfo = taskInfo->next)
+    {
+        taskInfo->queue = queue;
+        taskInfo->state = TaskState::eQueued;
+        taskInfo->enqueueTime = enqueueTime;
+    }
+
+    if (queue)
+    {
+        std::lock_guard lock(queue->mutex);
+        queue->tasks.splice(tasks);
+        m_queuedTasksCount += count;
+    }
+    else
+    {
+        std::lock_guard lock(m_taskQueueMutex);
+        m_priorityQueues[kNormalPriority].splice(tasks);
+        m_notEmptyLevels |= std::uint64_t(1) << kNormalPriority;
+        m_queuedTasksCount += count;
+    }
+    notify_sleeping_workers(count);
+    if (m_elastic)
+        notify_elastic_monitor();
+    if (m_collectMetrics)
+        on_tasks_submitted(count);
+
+    EXT_ASSERT(has_working_threads()) << "Threads interrupted or stopped";
+}
+
+inline thread_pool::TaskId thread_pool::enqueue_task(TaskInfoPtr&& taskInfo, bool placeReserved)
+{
+    if (!placeReserved && !reserve_queue_places(1))
+        return execute_in_caller_thread(std::move(taskInfo));
+
+    const TaskId taskId = taskInfo->get_id();
+    const Priority priority = taskInfo->priority;
+
+    // tasks added from the worker thread are executed by the same worker or NUMA node if nobody steals them,
+    // tasks ordered by deadline and fair share queues tasks are kept in the common queue
+    const bool commonQueueOnly = is_ordered_by_deadline(*taskInfo) || taskInfo->fairQueue != TaskInfo::kNoFairQueue;
+    if (TasksQueue* queue = priority == kNormalPriority && !commonQueueOnly ? get_current_thread_queue() : nullptr)
+    {
+        if (m_stampEnqueueTime)
+            taskInfo->enqueueTime = std::chrono::steady_clock::now();
+        {
+            std::lock_guard lock(queue->mutex);
+            taskInfo->queue = queue;
+            taskInfo->state = TaskState::eQueued;
+            queue->tasks.push_back(taskInfo.release());
+            ++m_queuedTasksCount;
+        }
+        notify_sleeping_workers();
+    }
+    else
+    {
+        // fair share queues always report the queue wait time
+        if (m_stampEnqueueTime || taskInfo->fairQueue != TaskInfo::kNoFairQueue)
+            taskInfo->enqueueTime = std::chrono::steady_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock(m_taskQueueMutex);
+            taskInfo->queue = nullptr;
+            taskInfo->state = TaskState::eQueued;
+            push_global_task(taskInfo.release());
+            ++m_queuedTasksCount;
+            if (claim_spinning_workers(1) == 0)
+                m_taskQueueChangedNotifier.notify_one();
+        }
+    }
+    if (m_elastic)
+        notify_elastic_monitor();
+    if (m_collectMetrics)
+        on_tasks_submitted(1);
+
+    EXT_ASSERT(has_working_threads()) << "Threads interrupted or stopped";
+
+    return taskId;
+}
+
+inline thread_pool::TaskId thread_pool::execute_in_caller_thread(TaskInfoPtr&& taskInfo)
+{
+    const TaskId taskId = taskInfo->get_id();
+    const bool hasDeadline = taskInfo->deadline != std::chrono::steady_clock::time_point::max();
+    const auto startTime = m_collectMetrics || hasDeadline ?
+        std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    // expired task completes its future with deadline_exceeded without function call
+    taskInfo->expired = hasDeadline && startTime >= taskInfo->deadline;
+
+    // task wrappers handle exceptions of the task function
+    taskInfo->task();
+    const bool expired = taskInfo->expired;
+    taskInfo.reset();
+
+    if (m_collectMetrics)
+    {
+        const auto executionTime = std::chrono::steady_clock::now() - startTime;
+        // task didn't wait in the queue, its wait time is zero
+        if (Worker* worker = get_current_worker())
+        {
+            worker->metrics.add_duration(worker->metrics.queueWaitTime, {});
+            if (expired)
+                MetricsCounters::increase<std::uint64_t>(worker->metrics.expiredTasksCount);
+            else
+            {
+                worker->metrics.add_duration(worker->metrics.executionTime, executionTime);
+                MetricsCounters::increase<std::uint64_t>(worker->metrics.completedTasksCount);
+            }
+        }
+        else if (expired)
+            m_externalExpiredTasksCount.fetch_add(1, std::memory_order_relaxed);
+        else
+        {
+            // several submitters change the counters
+            m_externalExecutionTime[DurationHistogram::get_bucket(executionTime)].fetch_add(1, std::memory_order_relaxed);
+            m_externalCompletedTasksCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (m_onTaskDone)
+        m_onTaskDone(taskId);
+    return taskId;
+}
+
+inline bool thread_pool::reserve_queue_places(std::size_t count)
+{
+    if (m_queueCapacity == 0 || try_reserve_queue_places(count))
+        return true;
+
+    switch (m_overflowPolicy)
+    {
+    case OverflowPolicy::eBlock:
+        {
+            // worker would wait for itself if all workers are blocked, it executes tasks instead
+            if (get_current_worker() != nullptr)
+                return false;
+
+            EXT_CHECK(count <= m_queueCapacity) << "Count of tasks " << count << " exceeds queue capacity";
+            std::unique_lock lock(m_queuePlacesMutex);
+            ++m_queuePlacesWaitersCount;
+            m_queuePlacesCv.wait(lock, [&]() { return try_reserve_queue_places(count); });
+            --m_queuePlacesWaitersCount;
+            return true;
+        }
+    case OverflowPolicy::eReject:
+        throw queue_overflow();
+    case OverflowPolicy::eCallerRuns:
+        return false;
+    case OverflowPolicy::eDropOldest:
+        EXT_CHECK(count <= m_queueCapacity) << "Count of tasks " << count << " exceeds queue capacity";
+        while (!try_reserve_queue_places(count))
+        {
+            // places might be taken by the tasks which are being added right now
+            if (!drop_oldest_task())
+                std::this_thread::yield();
         }
+        return true;
+    default:
+        static_assert(ext::reflection::get_enum_size<OverflowPolicy>() == 4,
+            "Overflow policy has unsupported value, extent this switch");
+        EXT_UNREACHABLE();
+    }
+}
 
-        auto runningIt = m_runningTasks.find(taskId);
-        if (runningIt == m_runningTasks.end())
+inline bool thread_pool::try_reserve_queue_places(std::size_t count) noexcept
+{
+    std::size_t placesUsed = m_queuePlacesUsed;
+    do
+    {
+        if (placesUsed + count > m_queueCapacity)
             return false;
+    } while (!m_queuePlacesUsed.compare_exchange_weak(placesUsed, placesUsed + count));
+    return true;
+}
+
+inline void thread_pool::release_queue_places(std::size_t count) noexcept
+{
+    if (m_queueCapacity == 0 || count == 0)
+        return;
+
+    m_queuePlacesUsed -= count;
+    if (m_queuePlacesWaitersCount == 0)
+        return;
 
-        threadToInterrupt = runningIt->second;
+    // waiter might check free places and go to sleep right now, wait till it releases the mutex
+    { std::lock_guard lock(m_queuePlacesMutex); }
+    m_queuePlacesCv.notify_all();
+}
+
+inline bool thread_pool::drop_oldest_task()
+{
+    // find the queue with the oldest task, the common queue is marked by nullptr
+    auto oldestTime = std::chrono::steady_clock::time_point::max();
+    TasksQueue* oldestQueue = nullptr;
+    bool found = false;
+    {
+        std::lock_guard lock(m_taskQueueMutex);
+        for (std::uint64_t levels = m_notEmptyLevels; levels != 0; levels &= levels - 1)
+        {
+            const auto level = static_cast<Priority>(thread_pool_details::highest_bit_index(levels & (~levels + 1)));
+            if (const TaskInfo* taskInfo = get_global_level_oldest_task(level);
+                taskInfo != nullptr && (!found || taskInfo->enqueueTime < oldestTime))
+            {
+                oldestTime = taskInfo->enqueueTime;
+                found = true;
+            }
+        }
+    }
+    // the oldest tasks of the NUMA nodes and workers queues are in the front
+    const auto checkFront = [&](TasksQueue& queue)
+    {
+        std::lock_guard lock(queue.mutex);
+        if (const TaskInfo* front = queue.tasks.front(); front != nullptr && (!found || front->enqueueTime < oldestTime))
+        {
+            oldestTime = front->enqueueTime;
+            oldestQueue = &queue;
+            found = true;
+        }
+    };
+    for (auto& node : m_numaNodes)
+    {
+        checkFront(node);
+    }
+    for (auto& worker : m_workers)
+    {
+        checkFront(worker);
     }
+    if (!found)
+        return false;
 
-    threadToInterrupt->interrupt();
+    // queues might be changed after checking, take the current oldest task of the selected queue
+    TaskInfo* droppedTask = nullptr;
+    if (oldestQueue == nullptr)
+    {
+        std::lock_guard lock(m_taskQueueMutex);
+        for (std::uint64_t levels = m_notEmptyLevels; levels != 0; levels &= levels - 1)
+        {
+            const auto level = static_cast<Priority>(thread_pool_details::highest_bit_index(levels & (~levels + 1)));
+            TaskInfo* taskInfo = get_global_level_oldest_task(level);
+            if (taskInfo != nullptr && (droppedTask == nullptr || taskInfo->enqueueTime < droppedTask->enqueueTime))
+                droppedTask = taskInfo;
+        }
+        if (droppedTask != nullptr)
+        {
+            erase_global_task(droppedTask);
+            droppedTask->state = TaskState::eFree;
+            --m_queuedTasksCount;
+        }
+    }
+    else
+    {
+        std::lock_guard lock(oldestQueue->mutex);
+        if (!oldestQueue->tasks.empty())
+        {
+            droppedTask = oldestQueue->tasks.pop_front();
+            droppedTask->state = TaskState::eFree;
+            --m_queuedTasksCount;
+        }
+    }
 
-    std::unique_lock lock(m_taskQueueMutex);
-    m_allTasksDoneCv.wait(lock, [&] {
-        return m_runningTasks.find(taskId) == m_runningTasks.end();
-    });
+    if (droppedTask == nullptr)
+        return false;
 
+    release_queue_places(1);
+    // task function destruction might call thread pool functions, do it without locks
+    release_task_info(droppedTask);
+    notify_task_done();
     return true;
 }
 
+inline bool thread_pool::stop_and_remove_task(const TaskId& taskId, bool waitInterrupted)
+{
+    TaskInfo* taskInfo = find_task_info(taskId.index);
+    if (taskInfo == nullptr)
+        return false;
+
+    // task state might be changed till we lock its queue or worker, check it again under the lock
+    while (taskInfo->generation == taskId.generation)
+    {
+        switch (taskInfo->state)
+        {
+        case TaskState::eQueued:
+            {
+                TasksQueue* queue = taskInfo->queue;
+                std::unique_lock lock(queue ? queue->mutex : m_taskQueueMutex);
+                if (taskInfo->generation != taskId.generation)
+                    return false;
+                if (taskInfo->state != TaskState::eQueued || taskInfo->queue != queue)
+                    continue;
+
+                if (queue)
+                    queue->tasks.erase(taskInfo);
+                else
+                    erase_global_task(taskInfo);
+                taskInfo->state = TaskState::eFree;
+                --m_queuedTasksCount;
+                lock.unlock();
+                release_queue_places(1);
+
+                // task function destruction might call thread pool functions, do it without locks
+                release_task_info(taskInfo);
+                notify_task_done();
+                return true;
+            }
+        case TaskState::eRunning:
+            {
+                Worker* executor = taskInfo->worker;
+                // task object might be reused and queued again
+                if (executor == nullptr)
+                    continue;
+                {
+                    std::lock_guard workerLock(executor->mutex);
+                    // worker might finish the task while we were taking the lock
+                    if (taskInfo->generation != taskId.generation || taskInfo->state != TaskState::eRunning)
+                        return true;
+                    if (taskInfo->worker != executor)
+                        continue;
+                    executor->thread.interrupt();
+                }
+                if (!waitInterrupted)
+                    return true;
+
+                std::unique_lock lock(m_taskQueueMutex);
+                ++m_tasksDoneWaitersCount;
+                m_allTasksDoneCv.wait(lock, [&] {
+                    return taskInfo->generation != taskId.generation || taskInfo->state != TaskState::eRunning;
+                });
+                --m_tasksDoneWaitersCount;
+                return true;
+            }
+        case TaskState::eFree:
+        case TaskState::eFinished:
+            return false;
+        default:
+            static_assert(ext::reflection::get_enum_size<TaskState>() == 4,
+                "Task state has unsupported value, extent this enum");
+            EXT_UNREACHABLE();
+        }
+    }
+    return false;
+}
+
 [[nodiscard]] inline std::size_t thread_pool::running_tasks_count() const noexcept
 {
+    return m_runningTasksCount;
+}
+
+[[nodiscard]] inline std::size_t thread_pool::threads_count() const noexcept
+{
+    return m_activeWorkersCount;
+}
+
+[[nodiscard]] inline thread_pool::Metrics thread_pool::get_metrics() const
+{
+    Metrics metrics;
+    metrics.total.submittedTasksCount = m_externalSubmittedTasksCount.load(std::memory_order_relaxed);
+    metrics.queueDepthHighWaterMark = m_queueDepthHighWaterMark.load(std::memory_order_relaxed);
+    metrics.queuedTasksCount = m_queuedTasksCount;
+    metrics.runningTasksCount = m_runningTasksCount;
+    metrics.hungTasksCount = m_hungTasksCount;
+
+    metrics.workers.reserve(m_workers.size());
+    for (const auto& worker : m_workers)
+    {
+        metrics.total += metrics.workers.emplace_back(worker.metrics.get_metrics());
+    }
+
+    WorkerMetrics externalMetrics;
+    externalMetrics.completedTasksCount = m_externalCompletedTasksCount.load(std::memory_order_relaxed);
+    externalMetrics.expiredTasksCount = m_externalExpiredTasksCount.load(std::memory_order_relaxed);
+    externalMetrics.queueWaitTime.buckets[DurationHistogram::get_bucket({})] =
+        externalMetrics.completedTasksCount + externalMetrics.expiredTasksCount;
+    for (std::size_t i = 0; i < DurationHistogram::kBucketsCount; ++i)
+    {
+        externalMetrics.executionTime.buckets[i] = m_externalExecutionTime[i].load(std::memory_order_relaxed);
+    }
+    metrics.total += externalMetrics;
+    return metrics;
+}
+
+[[nodiscard]] inline thread_pool::ThreadsCounters thread_pool::get_threads_counters() const noexcept
+{
+    std::lock_guard lock(m_workersMutex);
+    ThreadsCounters counters = m_threadsCounters;
+    counters.threadsCount = m_activeWorkersCount;
+    counters.blockedThreadsCount = m_blockedWorkersCount;
+    counters.compensatingThreadsCount = m_compensatingWorkersCount;
+    return counters;
+}
+
+inline thread_pool::QueueId thread_pool::add_queue(std::string name, std::uint32_t weight)
+{
+    EXT_CHECK(weight != 0) << "Queue weight must be positive";
+
+    std::lock_guard lock(m_taskQueueMutex);
+    EXT_CHECK(m_fairQueuesCount < TaskInfo::kNoFairQueue) << "Too many queues";
+    m_fairQueues.emplace_back(std::move(name), weight);
+    return m_fairQueuesCount++;
+}
+
+inline thread_pool::QueueStats thread_pool::get_queue_stats(QueueId queue) const
+{
+    EXT_CHECK(queue < m_fairQueuesCount) << "Unknown queue " << queue;
+
     std::lock_guard lock(m_taskQueueMutex);
-    return m_runningTasks.size();
+    const FairQueue& fairQueue = m_fairQueues[queue];
+    QueueStats stats;
+    stats.name = fairQueue.name;
+    stats.weight = fairQueue.weight;
+    stats.queuedTasksCount = fairQueue.tasks.size();
+    stats.startedTasksCount = fairQueue.startedTasksCount;
+    stats.queueWaitTime = fairQueue.queueWaitTime;
+    return stats;
 }
 
 inline void thread_pool::interrupt_and_remove_all_tasks()
 {
+    TasksList removedTasks;
     {
         std::lock_guard<std::mutex> lock(m_taskQueueMutex);
-        m_queueTasks.clear();
-        std::for_each(m_threads.begin(), m_threads.end(), std::mem_fn(&ext::thread::interrupt));
+        take_global_tasks(removedTasks);
+
+        for (auto& node : m_numaNodes)
+        {
+            std::lock_guard nodeLock(node.mutex);
+            take_queued_tasks(node.tasks, removedTasks);
+        }
+
+        std::lock_guard workersLock(m_workersMutex);
+        for (auto& worker : m_workers)
+        {
+            std::lock_guard workerLock(worker.mutex);
+            take_queued_tasks(worker.tasks, removedTasks);
+            if (worker.active)
+                worker.thread.interrupt();
+        }
     }
     m_allTasksDoneCv.notify_all();
 
+    // tasks functions destruction might call thread pool functions, do it without locks
+    release_tasks(removedTasks);
+
     wait_for_tasks();
 }
 
 inline thread_pool::thread_pool(std::function<void(const TaskId&)>&& onTaskDone, std::uint_fast32_t threadsCount)
-    : m_onTaskDone(std::move(onTaskDone))
-    , m_threads(threadsCount, {})
-{
-    for (auto& thread : m_threads)
-        thread.run(&thread_pool::worker, this, std::ref(thread));
-}
+    : thread_pool(Options{ threadsCount }, std::move(onTaskDone))
+{}
 
 inline thread_pool::thread_pool(std::uint_fast32_t threadsCount)
     : thread_pool(nullptr, threadsCount)
 {}
 
+inline thread_pool::thread_pool(const Options& options, std::function<void(const TaskId&)>&& onTaskDone)
+    : m_priorityQueues(options.priorityLevelsCount)
+    , m_deadlineQueues(options.earliestDeadlineFirst ? options.priorityLevelsCount : 0)
+    , m_agingTime(options.agingTime)
+    , m_onTaskDone(std::move(onTaskDone))
+    , m_workStealing(options.workStealing)
+    , m_queueCapacity(options.queueCapacity)
+    , m_overflowPolicy(options.overflowPolicy)
+    , m_idleSpinSteps(options.idleSpinSteps)
+    , m_threadsName(options.threadsName)
+    , m_workersCpus(options.workersCpus)
+    , m_workers(std::max(options.threadsCount, options.maxThreadsCount) + options.maxCompensatingThreadsCount)
+    , m_minThreadsCount(options.threadsCount)
+    , m_elastic(options.maxThreadsCount > options.threadsCount)
+    , m_spawnThreadLatency(options.spawnThreadLatency)
+    , m_idleThreadTimeout(options.idleThreadTimeout)
+    , m_collectMetrics(options.collectMetrics)
+    , m_stampEnqueueTime(m_elastic || m_collectMetrics || m_agingTime != std::chrono::steady_clock::duration::zero() ||
+                         (m_queueCapacity != 0 && m_overflowPolicy == OverflowPolicy::eDropOldest))
+    , m_earliestDeadlineFirst(options.earliestDeadlineFirst)
+    , m_maxThreadsCount(std::max(options.threadsCount, options.maxThreadsCount))
+    , m_hungTaskTimeout(options.hungTaskTimeout)
+    , m_interruptHungTasks(options.interruptHungTasks)
+{
+    EXT_CHECK(options.priorityLevelsCount != 0 && options.priorityLevelsCount <= kMaxPriorityLevelsCount)
+        << "Unsupported priority levels count " << options.priorityLevelsCount;
+    EXT_CHECK(options.maxThreadsCount == 0 || options.maxThreadsCount >= options.threadsCount)
+        << "Max threads count " << options.maxThreadsCount << " is less than threads count " << options.threadsCount;
+
+    EXT_CHECK(!options.numaAware || options.workersCpus.empty())
+        << "Workers cpus can't be used together with NUMA aware placement";
+
+    if (options.numaAware)
+    {
+        auto nodesCpus = options.numaNodesCpus.empty() ? thread_details::get_numa_nodes_cpus() : options.numaNodesCpus;
+        m_numaNodes = std::vector<NumaNode>(nodesCpus.size());
+        for (std::size_t i = 0; i < m_numaNodes.size(); ++i)
+        {
+            m_numaNodes[i].cpus = std::move(nodesCpus[i]);
+        }
+    }
+
+    for (std::size_t i = 0; i < m_workers.size(); ++i)
+    {
+        m_workers[i].pool = this;
+        // workers are distributed over nodes round-robin, elastic pool slots keep their node
+        if (!m_numaNodes.empty())
+            m_workers[i].node = &m_numaNodes[i % m_numaNodes.size()];
+    }
+
+    std::lock_guard lock(m_workersMutex);
+    for (std::size_t i = 0; i < m_minThreadsCount; ++i)
+    {
+        m_workers[i].active = true;
+        m_workers[i].thread.run(&thread_pool::worker, this, std::ref(m_workers[i]));
+    }
+    m_activeWorkersCount = m_minThreadsCount;
+    m_threadsCounters.peakThreadsCount = m_minThreadsCount;
+
+    if (m_elastic)
+        m_elasticMonitor = std::thread(&thread_pool::elastic_monitor, this);
+    if (m_hungTaskTimeout != std::chrono::steady_clock::duration::zero())
+        m_watchdog = std::thread(&thread_pool::watchdog, this);
+}
+
 inline thread_pool::~thread_pool()
 {
     m_threadPoolWorks = false;
 
+    TasksList removedTasks;
     {
         std::lock_guard<std::mutex> lock(m_taskQueueMutex);
-        std::for_each(m_threads.begin(), m_threads.end(), std::mem_fn(&ext::thread::interrupt));
-        m_queueTasks.clear();
+        // new threads are not started after m_threadPoolWorks reset
+        std::lock_guard workersLock(m_workersMutex);
+        for (auto& worker : m_workers)
+        {
+            std::lock_guard workerLock(worker.mutex);
+            if (worker.active)
+                worker.thread.interrupt();
+            take_queued_tasks(worker.tasks, removedTasks);
+        }
+        for (auto& node : m_numaNodes)
+        {
+            std::lock_guard nodeLock(node.mutex);
+            take_queued_tasks(node.tasks, removedTasks);
+        }
+        take_global_tasks(removedTasks);
         m_taskQueueChangedNotifier.notify_all();
     }
+    release_tasks(removedTasks);
+
+    if (m_elasticMonitor.joinable())
+    {
+        { std::lock_guard lock(m_taskQueueMutex); }
+        m_elasticMonitorCv.notify_all();
+        m_elasticMonitor.join();
+    }
+    if (m_watchdog.joinable())
+    {
+        { std::lock_guard lock(m_watchdogMutex); }
+        m_watchdogCv.notify_all();
+        m_watchdog.join();
+    }
 
-    std::for_each(m_threads.begin(), m_threads.end(), [](ext::thread& thread) {
-        thread.join();
+    // retired threads of the elastic pool are joined too
+    std::for_each(m_workers.begin(), m_workers.end(), [](Worker& worker) {
+        if (worker.thread.joinable())
+            worker.thread.join();
     });
 
     m_allTasksDoneCv.notify_all();
+
+    // all tasks are released, free objects storage
+    for (auto& chunk : m_tasksChunks)
+    {
+        delete[] chunk.load();
+    }
 }
 
 inline void thread_pool::wait_for_tasks() const
 {
     std::unique_lock lock(m_taskQueueMutex);
 
+    ++m_tasksDoneWaitersCount;
     m_allTasksDoneCv.wait(lock, [&] {
-        return m_queueTasks.empty() && m_runningTasks.empty();
+        return m_queuedTasksCount == 0 && m_runningTasksCount == 0;
     });
+    --m_tasksDoneWaitersCount;
 }
 
-inline void thread_pool::worker(ext::thread& workerThread)
+inline void thread_pool::worker(Worker& worker)
 {
+    current_thread_worker() = &worker;
+    apply_worker_settings(worker);
+
     while (m_threadPoolWorks)
     {
-        thread_pool::TaskInfoPtr taskToExecute;
+        thread_pool::TaskInfoPtr taskToExecute = pop_task(worker);
+        if (!taskToExecute)
         {
+            const auto idleStart = m_collectMetrics ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            if (m_idleSpinSteps != 0 && spin_wait_for_tasks())
+            {
+                if (m_collectMetrics)
+                    MetricsCounters::increase<std::int64_t>(worker.metrics.idleTimeNs,
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - idleStart).count());
+                continue;
+            }
+
             std::unique_lock<std::mutex> lock(m_taskQueueMutex);
 
-            m_taskQueueChangedNotifier.wait(lock, [&]() { return !m_queueTasks.empty() || !m_threadPoolWorks; });
-            if (!m_threadPoolWorks && m_queueTasks.empty())
+            const auto retire = [&]()
+            {
+                lock.unlock();
+                // share cached objects with other threads, the worker slot might be reused by a new thread
+                std::lock_guard freeTasksLock(m_freeTasksMutex);
+                m_freeTasks.splice(worker.freeTasks);
+            };
+            // blocked workers returned, the thread which replaced them is not needed. Workers of the pool slots
+            // keep working, the slot index defines the worker cpus and NUMA node
+            if (worker.compensating && m_compensatingWorkersCount > m_blockedWorkersCount &&
+                try_retire_compensating_worker(worker))
+            {
+                retire();
                 return;
+            }
 
-            taskToExecute = std::move(m_queueTasks.front());
-            m_queueTasks.pop_front();
-
-            m_runningTasks.emplace(taskToExecute->taskId, &workerThread);
+            const auto hasWork = [&]()
+            {
+                return m_queuedTasksCount != 0 || !m_threadPoolWorks ||
+                    (worker.compensating && m_compensatingWorkersCount > m_blockedWorkersCount);
+            };
+            bool woken = true;
+            ++m_sleepingWorkersCount;
+            if (m_elastic)
+                woken = m_taskQueueChangedNotifier.wait_for(lock, m_idleThreadTimeout, hasWork);
+            else
+                m_taskQueueChangedNotifier.wait(lock, hasWork);
+            --m_sleepingWorkersCount;
+            if (m_collectMetrics)
+                MetricsCounters::increase<std::int64_t>(worker.metrics.idleTimeNs,
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - idleStart).count());
+
+            if (!woken && try_retire_worker(worker))
+            {
+                retire();
+                return;
+            }
+            continue;
         }
 
-        taskToExecute->task();
+        execute_task(worker, std::move(taskToExecute));
+    }
+}
+
+inline void thread_pool::execute_task(Worker& worker, TaskInfoPtr&& taskToExecute)
+{
+    const bool hasDeadline = taskToExecute->deadline != std::chrono::steady_clock::time_point::max();
+    const auto startTime = m_collectMetrics || hasDeadline ?
+        std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    if (m_collectMetrics)
+        worker.metrics.add_duration(worker.metrics.queueWaitTime, startTime - taskToExecute->enqueueTime);
+
+    // expired task completes its future with deadline_exceeded without function call
+    taskToExecute->expired = hasDeadline && startTime >= taskToExecute->deadline;
+
+    // worker might be executing this task while waiting for the future of the previous one
+    const bool watched = m_hungTaskTimeout != std::chrono::steady_clock::duration::zero();
+    TaskInfo* previousWatchedTask = nullptr;
+    std::chrono::steady_clock::time_point previousWatchedTaskStartTime;
+    bool previousWatchedTaskReported = false;
+    if (watched)
+    {
+        std::lock_guard lock(worker.mutex);
+        previousWatchedTask = std::exchange(worker.watchedTask, taskToExecute.get());
+        previousWatchedTaskStartTime = std::exchange(worker.watchedTaskStartTime, std::chrono::steady_clock::now());
+        previousWatchedTaskReported = std::exchange(worker.watchedTaskReported, false);
+    }
+
+    taskToExecute->task();
+    // destroy function with arguments right after execution
+    taskToExecute->task.reset();
+
+    if (m_collectMetrics)
+    {
+        if (taskToExecute->expired)
+            MetricsCounters::increase<std::uint64_t>(worker.metrics.expiredTasksCount);
+        else
+        {
+            worker.metrics.add_duration(worker.metrics.executionTime, std::chrono::steady_clock::now() - startTime);
+            MetricsCounters::increase<std::uint64_t>(worker.metrics.completedTasksCount);
+        }
+    }
 
-        if (m_onTaskDone)
-            m_onTaskDone(taskToExecute->taskId);
+    if (m_onTaskDone)
+        m_onTaskDone(taskToExecute->get_id());
 
+    {
+        std::lock_guard lock(worker.mutex);
+        taskToExecute->state = TaskState::eFinished;
+        if (watched)
         {
-            std::lock_guard lock(m_taskQueueMutex);
-            m_runningTasks.erase(taskToExecute->taskId);
+            worker.watchedTask = previousWatchedTask;
+            worker.watchedTaskStartTime = previousWatchedTaskStartTime;
+            worker.watchedTaskReported = previousWatchedTaskReported;
         }
 
         // If thread was interrupted during task execution, we should restore it to be able to execute next tasks
-        if (workerThread.interrupted())
-            workerThread.restore_interrupted();
+        if (worker.thread.interrupted())
+            worker.thread.restore_interrupted();
+    }
+    taskToExecute.reset();
+    --m_runningTasksCount;
 
-        m_allTasksDoneCv.notify_all();
+    notify_task_done();
+}
+
+inline thread_pool::TaskInfoPtr thread_pool::pop_task(Worker& worker)
+{
+    if (!m_workStealing && worker.node == nullptr)
+        return pop_global_task(worker);
+
+    if (++worker.popsCount % kGlobalQueueCheckInterval == 0)
+    {
+        if (auto task = pop_global_task(worker))
+            return task;
+    }
+
+    if (m_workStealing)
+    {
+        if (auto task = pop_local_task(worker))
+            return task;
     }
+    if (worker.node != nullptr)
+    {
+        if (auto task = pop_node_task(worker))
+            return task;
+    }
+    if (auto task = pop_global_task(worker))
+        return task;
+    return steal_task(worker);
+}
+
+inline thread_pool::TaskInfoPtr thread_pool::pop_global_task(Worker& worker)
+{
+    std::lock_guard lock(m_taskQueueMutex);
+    if (m_notEmptyLevels == 0)
+        return TaskInfoPtr(nullptr, TaskInfoDeleter{ this });
+
+    const Priority level = get_next_global_task_level();
+    TaskInfo* taskInfo = level == kNormalPriority && m_fairQueuedTasksCount != 0 ?
+        pop_fair_share_task() : pop_global_level_task(level);
+    if (is_global_level_empty(level))
+        m_notEmptyLevels &= ~(std::uint64_t(1) << level);
+    return start_task(taskInfo, worker);
+}
+
+inline thread_pool::TaskInfoPtr thread_pool::pop_local_task(Worker& worker)
+{
+    std::lock_guard lock(worker.mutex);
+    if (worker.tasks.empty())
+        return TaskInfoPtr(nullptr, TaskInfoDeleter{ this });
+
+    // the last added task has the best chance to have its data in the cache
+    return start_task(worker.tasks.pop_back(), worker);
+}
+
+inline thread_pool::TaskInfoPtr thread_pool::pop_node_task(Worker& worker)
+{
+    std::lock_guard lock(worker.node->mutex);
+    if (worker.node->tasks.empty())
+        return TaskInfoPtr(nullptr, TaskInfoDeleter{ this });
+
+    return start_task(worker.node->tasks.pop_front(), worker);
 }
 
-} // namespace ext
\ No newline at end of file
+inline thread_pool::TaskInfoPtr thread_pool::steal_task(Worker& thief)
+{
+    if (m_workStealing)
+    {
+        const std::size_t workersCount = m_workers.size();
+        const std::size_t thiefIndex = static_cast<std::size_t>(&thief - m_workers.data());
+        for (std::size_t i = 1; i < workersCount; ++i)
+        {
+            Worker& victim = m_workers[(thiefIndex + i) % workersCount];
+
+            std::lock_guard lock(victim.mutex);
+            if (victim.tasks.empty())
+                continue;
+
+            if (m_collectMetrics)
+                MetricsCounters::increase<std::uint64_t>(thief.metrics.stolenTasksCount);
+            // steal the oldest task, the owner works with the newest ones
+            return start_task(victim.tasks.pop_front(), thief);
+        }
+    }
+
+    // other nodes tasks are taken only when the own node has nothing to do
+    const std::size_t nodesCount = m_numaNodes.size();
+    const std::size_t thiefNodeIndex = thief.node ? static_cast<std::size_t>(thief.node - m_numaNodes.data()) : 0;
+    for (std::size_t i = 1; i < nodesCount; ++i)
+    {
+        NumaNode& node = m_numaNodes[(thiefNodeIndex + i) % nodesCount];
+
+        std::lock_guard lock(node.mutex);
+        if (node.tasks.empty())
+            continue;
+
+        if (m_collectMetrics)
+            MetricsCounters::increase<std::uint64_t>(thief.metrics.stolenTasksCount);
+        return start_task(node.tasks.pop_front(), thief);
+    }
+    return TaskInfoPtr(nullptr, TaskInfoDeleter{ this });
+}
+
+inline void thread_pool::apply_worker_settings(Worker& worker)
+{
+    const std::size_t index = static_cast<std::size_t>(&worker - m_workers.data());
+    if (!m_threadsName.empty() && !ext::this_thread::set_name(m_threadsName + std::to_string(index)))
+    {
+        EXT_TRACE_ERR() << EXT_TRACE_FUNCTION << "Failed to set name of the worker " << index;
+    }
+
+    std::vector<unsigned> cpus;
+    if (worker.node != nullptr)
+        cpus = worker.node->cpus;
+    else if (!m_workersCpus.empty())
+        cpus.emplace_back(m_workersCpus[index % m_workersCpus.size()]);
+
+    if (!cpus.empty() && !ext::this_thread::set_affinity(cpus))
+    {
+        EXT_TRACE_ERR() << EXT_TRACE_FUNCTION << "Failed to pin worker " << index << " to cpus";
+    }
+}
+
+inline thread_pool::TaskInfoPtr thread_pool::acquire_task_info(Priority priority)
+{
+    TaskInfo* taskInfo = nullptr;
+    if (Worker* worker = get_current_worker(); worker != nullptr && !worker->freeTasks.empty())
+        taskInfo = worker->freeTasks.pop_back();
+    else
+    {
+        std::lock_guard lock(m_freeTasksMutex);
+        if (m_freeTasks.empty())
+            allocate_tasks_chunk();
+        taskInfo = m_freeTasks.pop_back();
+    }
+
+#ifdef EXT_THREAD_POOL_UUID_TASK_ID
+    taskInfo->uuid = ext::uuid();
+#endif
+    taskInfo->priority = priority;
+    return TaskInfoPtr(taskInfo, TaskInfoDeleter{ this });
+}
+
+inline thread_pool::TasksList thread_pool::acquire_task_infos(Priority priority, std::size_t count)
+{
+    TasksList tasks;
+    if (Worker* worker = get_current_worker())
+    {
+        while (tasks.size() < count && !worker->freeTasks.empty())
+        {
+            tasks.push_back(worker->freeTasks.pop_back());
+        }
+    }
+
+    if (tasks.size() < count)
+    {
+        try
+        {
+            std::lock_guard lock(m_freeTasksMutex);
+            while (tasks.size() < count)
+            {
+                if (m_freeTasks.empty())
+                    allocate_tasks_chunk();
+                tasks.push_back(m_freeTasks.pop_back());
+            }
+        }
+        catch (...)
+        {
+            release_tasks(tasks);
+            throw;
+        }
+    }
+
+    for (TaskInfo* taskInfo = tasks.front(); taskInfo != nullptr; taskInfo = taskInfo->next)
+    {
+#ifdef EXT_THREAD_POOL_UUID_TASK_ID
+        taskInfo->uuid = ext::uuid();
+#endif
+        taskInfo->priority = priority;
+    }
+    return tasks;
+}
+
+inline void thread_pool::allocate_tasks_chunk()
+{
+    EXT_EXPECT(m_tasksChunksCount < kMaxTasksChunksCount) << "Too many tasks in the thread pool";
+
+    const std::uint32_t chunkSize = std::uint32_t(1) << (kFirstTasksChunkSizeLog + m_tasksChunksCount);
+    // sum of the previous chunks sizes
+    const std::uint32_t firstIndex = chunkSize - (std::uint32_t(1) << kFirstTasksChunkSizeLog);
+
+    TaskInfo* chunk = new TaskInfo[chunkSize];
+    for (std::uint32_t i = 0; i < chunkSize; ++i)
+    {
+        chunk[i].index = firstIndex + i;
+        m_freeTasks.push_front(&chunk[i]);
+    }
+    m_tasksChunks[m_tasksChunksCount++].store(chunk, std::memory_order_release);
+}
+
+inline thread_pool::TaskInfo* thread_pool::find_task_info(std::uint32_t index) const noexcept
+{
+    // chunk number is the position of the highest bit in the index shifted by the first chunk size
+    const std::uint64_t position = std::uint64_t(index) + (std::uint64_t(1) << kFirstTasksChunkSizeLog);
+    const std::size_t chunkNumber = thread_pool_details::highest_bit_index(position) - kFirstTasksChunkSizeLog;
+    if (chunkNumber >= kMaxTasksChunksCount)
+        return nullptr;
+
+    TaskInfo* chunk = m_tasksChunks[chunkNumber].load(std::memory_order_acquire);
+    if (chunk == nullptr)
+        return nullptr;
+    return chunk + (position - (std::uint64_t(1) << (kFirstTasksChunkSizeLog + chunkNumber)));
+}
+
+inline void thread_pool::push_global_task(TaskInfo* taskInfo) noexcept
+{
+    TasksList& queue = taskInfo->fairQueue == TaskInfo::kNoFairQueue ?
+        m_priorityQueues[taskInfo->priority] : m_fairQueues[taskInfo->fairQueue].tasks;
+    if (taskInfo->fairQueue != TaskInfo::kNoFairQueue)
+        ++m_fairQueuedTasksCount;
+
+    queue.push_back(taskInfo);
+    if (is_ordered_by_deadline(*taskInfo))
+    {
+        taskInfo->deadlineSequence = m_deadlineTasksSequence++;
+        m_deadlineQueues[taskInfo->priority].push(taskInfo);
+    }
+    m_notEmptyLevels |= std::uint64_t(1) << taskInfo->priority;
+}
+
+inline void thread_pool::erase_global_task(TaskInfo* taskInfo) noexcept
+{
+    if (taskInfo->fairQueue == TaskInfo::kNoFairQueue)
+    {
+        m_priorityQueues[taskInfo->priority].erase(taskInfo);
+        if (is_ordered_by_deadline(*taskInfo))
+            m_deadlineQueues[taskInfo->priority].erase(taskInfo);
+    }
+    else
+    {
+        m_fairQueues[taskInfo->fairQueue].tasks.erase(taskInfo);
+        --m_fairQueuedTasksCount;
+    }
+    if (is_global_level_empty(taskInfo->priority))
+        m_notEmptyLevels &= ~(std::uint64_t(1) << taskInfo->priority);
+}
+
+inline thread_pool::TaskInfo* thread_pool::pop_global_level_task(Priority level) noexcept
+{
+    if (!m_deadlineQueues.empty())
+    {
+        if (TaskInfo* taskInfo = m_deadlineQueues[level].pop())
+        {
+            m_priorityQueues[level].erase(taskInfo);
+            return taskInfo;
+        }
+    }
+    return m_priorityQueues[level].pop_front();
+}
+
+inline bool thread_pool::is_ordered_by_deadline(const TaskInfo& taskInfo) const noexcept
+{
+    return m_earliestDeadlineFirst && taskInfo.deadline != std::chrono::steady_clock::time_point::max() &&
+        taskInfo.fairQueue == TaskInfo::kNoFairQueue;
+}
+
+inline thread_pool::Priority thread_pool::get_next_global_task_level() const noexcept
+{
+    const auto highestLevel = static_cast<Priority>(thread_pool_details::highest_bit_index(m_notEmptyLevels));
+    if (m_agingTime == std::chrono::steady_clock::duration::zero() ||
+        m_notEmptyLevels == (std::uint64_t(1) << highestLevel))
+        return highestLevel;
+
+    // select the level with the oldest of the aged tasks
+    Priority level = highestLevel;
+    auto oldestTime = std::chrono::steady_clock::now() - m_agingTime;
+    for (std::uint64_t levels = m_notEmptyLevels; levels != 0;)
+    {
+        const auto currentLevel = static_cast<Priority>(thread_pool_details::highest_bit_index(levels));
+        levels &= ~(std::uint64_t(1) << currentLevel);
+
+        const auto enqueueTime = get_global_level_oldest_time(currentLevel);
+        if (enqueueTime < oldestTime)
+        {
+            oldestTime = enqueueTime;
+            level = currentLevel;
+        }
+    }
+    return level;
+}
+
+inline bool thread_pool::is_global_level_empty(Priority level) const noexcept
+{
+    return m_priorityQueues[level].empty() && (level != kNormalPriority || m_fairQueuedTasksCount == 0);
+}
+
+inline std::chrono::steady_clock::time_point thread_pool::get_global_level_oldest_time(Priority level) const noexcept
+{
+    const TaskInfo* oldestTask = get_global_level_oldest_task(level);
+    return oldestTask ? oldestTask->enqueueTime : std::chrono::steady_clock::time_point::max();
+}
+
+inline thread_pool::TaskInfo* thread_pool::get_global_level_oldest_task(Priority level) const noexcept
+{
+    // level and fair share queues are FIFO, the oldest task of each queue is in its front
+    TaskInfo* oldestTask = m_priorityQueues[level].front();
+    if (level == kNormalPriority && m_fairQueuedTasksCount != 0)
+    {
+        for (const auto& fairQueue : m_fairQueues)
+        {
+            TaskInfo* front = fairQueue.tasks.front();
+            if (front != nullptr && (oldestTask == nullptr || front->enqueueTime < oldestTask->enqueueTime))
+                oldestTask = front;
+        }
+    }
+    return oldestTask;
+}
+
+inline thread_pool::TaskInfo* thread_pool::pop_fair_share_task() noexcept
+{
+    // deficit round robin with the cost 1 for each task, the common queue takes part in it with weight 1.
+    // Queue without tasks loses the rest of its turn, so at least one queue in the round has tasks
+    while (true)
+    {
+        const bool commonQueueTurn = m_fairShareTurn == 0;
+        TasksList& tasks = commonQueueTurn ? m_priorityQueues[kNormalPriority] : m_fairQueues[m_fairShareTurn - 1].tasks;
+        if (m_fairShareTurnTasksLeft != 0 && !tasks.empty())
+        {
+            --m_fairShareTurnTasksLeft;
+            TaskInfo* taskInfo = commonQueueTurn ? pop_global_level_task(kNormalPriority) : tasks.pop_front();
+            if (!commonQueueTurn)
+            {
+                FairQueue& fairQueue = m_fairQueues[m_fairShareTurn - 1];
+                --m_fairQueuedTasksCount;
+                ++fairQueue.startedTasksCount;
+                ++fairQueue.queueWaitTime.buckets[DurationHistogram::get_bucket(
+                    std::chrono::steady_clock::now() - taskInfo->enqueueTime)];
+            }
+            return taskInfo;
+        }
+
+        m_fairShareTurn = (m_fairShareTurn + 1) % (m_fairQueues.size() + 1);
+        m_fairShareTurnTasksLeft = m_fairShareTurn == 0 ? 1 : m_fairQueues[m_fairShareTurn - 1].weight;
+    }
+}
+
+inline void thread_pool::take_global_tasks(TasksList& removedTasks) noexcept
+{
+    for (auto& queue : m_priorityQueues)
+    {
+        take_queued_tasks(queue, removedTasks);
+    }
+    for (auto& deadlineQueue : m_deadlineQueues)
+    {
+        deadlineQueue.clear();
+    }
+    for (auto& fairQueue : m_fairQueues)
+    {
+        take_queued_tasks(fairQueue.tasks, removedTasks);
+    }
+    m_fairQueuedTasksCount = 0;
+    m_notEmptyLevels = 0;
+}
+
+inline void thread_pool::elastic_monitor()
+{
+    const auto checkInterval = std::max<std::chrono::steady_clock::duration>(m_spawnThreadLatency, kMinElasticCheckInterval);
+
+    std::unique_lock lock(m_taskQueueMutex);
+    while (m_threadPoolWorks)
+    {
+        if (m_queuedTasksCount == 0)
+        {
+            m_elasticMonitorIdle = true;
+            m_elasticMonitorCv.wait(lock, [&]() { return m_queuedTasksCount != 0 || !m_threadPoolWorks; });
+            m_elasticMonitorIdle = false;
+            continue;
+        }
+
+        // sleeping workers will take queued tasks by themselves, pool without threads starts one immediately
+        if (m_sleepingWorkersCount == 0 &&
+            (m_activeWorkersCount == 0 ||
+             get_oldest_queued_task_time() < std::chrono::steady_clock::now() - m_spawnThreadLatency))
+        {
+            lock.unlock();
+            try_spawn_worker();
+            lock.lock();
+        }
+
+        m_elasticMonitorCv.wait_for(lock, checkInterval, [&]() { return !m_threadPoolWorks; });
+    }
+}
+
+inline void thread_pool::notify_elastic_monitor()
+{
+    if (!m_elasticMonitorIdle)
+        return;
+
+    // monitor might check tasks count and go to sleep right now, wait till it releases the mutex
+    { std::lock_guard lock(m_taskQueueMutex); }
+    m_elasticMonitorCv.notify_one();
+}
+
+inline void thread_pool::watchdog()
+{
+    const auto checkInterval = std::max<std::chrono::steady_clock::duration>(m_hungTaskTimeout / 4, kMinWatchdogCheckInterval);
+
+    std::unique_lock lock(m_watchdogMutex);
+    while (!m_watchdogCv.wait_for(lock, checkInterval, [&]() { return !m_threadPoolWorks; }))
+    {
+        lock.unlock();
+        for (std::size_t index = 0; index < m_workers.size(); ++index)
+        {
+            Worker& worker = m_workers[index];
+            TaskId taskId;
+            std::thread::id threadId;
+            std::chrono::steady_clock::duration elapsed;
+            {
+                std::lock_guard workerLock(worker.mutex);
+                if (worker.watchedTask == nullptr || worker.watchedTaskReported)
+                    continue;
+                elapsed = std::chrono::steady_clock::now() - worker.watchedTaskStartTime;
+                if (elapsed < m_hungTaskTimeout)
+                    continue;
+
+                worker.watchedTaskReported = true;
+                ++m_hungTasksCount;
+                taskId = worker.watchedTask->get_id();
+                threadId = worker.thread.get_id();
+                if (m_interruptHungTasks)
+                    worker.thread.interrupt();
+            }
+
+            EXT_TRACE_ERR() << EXT_TRACE_FUNCTION << "Task " << taskId.index << ":" << taskId.generation
+                            << " is running for " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()
+                            << "ms in worker " << index << " thread " << threadId
+                            << (m_interruptHungTasks ? ", interrupting it" : "");
+        }
+        lock.lock();
+    }
+}
+
+inline std::chrono::steady_clock::time_point thread_pool::get_oldest_queued_task_time() noexcept
+{
+    auto oldestTime = std::chrono::steady_clock::time_point::max();
+    for (std::uint64_t levels = m_notEmptyLevels; levels != 0;)
+    {
+        const auto level = static_cast<Priority>(thread_pool_details::highest_bit_index(levels));
+        levels &= ~(std::uint64_t(1) << level);
+        oldestTime = std::min(oldestTime, get_global_level_oldest_time(level));
+    }
+
+    if (m_workStealing)
+    {
+        // the oldest task of the worker queue is in the front, the owner works with the newest ones
+        for (auto& worker : m_workers)
+        {
+            std::lock_guard workerLock(worker.mutex);
+            if (!worker.tasks.empty())
+                oldestTime = std::min(oldestTime, worker.tasks.front()->enqueueTime);
+        }
+    }
+    for (auto& node : m_numaNodes)
+    {
+        std::lock_guard nodeLock(node.mutex);
+        if (!node.tasks.empty())
+            oldestTime = std::min(oldestTime, node.tasks.front()->enqueueTime);
+    }
+    return oldestTime;
+}
+
+inline void thread_pool::try_spawn_worker()
+{
+    std::lock_guard lock(m_workersMutex);
+    if (!m_threadPoolWorks)
+        return;
+
+    // give the previous started thread time to decrease the latency
+    const auto now = std::chrono::steady_clock::now();
+    if (m_activeWorkersCount != 0 && now - m_lastSpawnTime < m_spawnThreadLatency)
+        return;
+
+    // compensating threads don't take the elastic pool slots
+    if (m_activeWorkersCount - m_compensatingWorkersCount >= m_maxThreadsCount || !start_worker())
+    {
+        ++m_threadsCounters.maxThreadsReachedCount;
+        return;
+    }
+    m_lastSpawnTime = now;
+}
+
+inline bool thread_pool::start_worker(bool compensating)
+{
+    const auto workerIt = std::find_if(m_workers.begin(), m_workers.end(), [](const Worker& worker) { return !worker.active; });
+    if (workerIt == m_workers.end())
+        return false;
+
+    // retired thread of this slot is finishing or already finished
+    if (workerIt->thread.joinable())
+        workerIt->thread.join();
+
+    workerIt->active = true;
+    workerIt->compensating = compensating;
+    ++m_threadsCounters.spawnedThreadsCount;
+    m_threadsCounters.peakThreadsCount = std::max<std::size_t>(m_threadsCounters.peakThreadsCount, ++m_activeWorkersCount);
+
+    try
+    {
+        workerIt->thread.run(&thread_pool::worker, this, std::ref(*workerIt));
+    }
+    catch (...)
+    {
+        workerIt->active = false;
+        workerIt->compensating = false;
+        --m_activeWorkersCount;
+        throw;
+    }
+    return true;
+}
+
+inline bool thread_pool::try_retire_worker(Worker& worker)
+{
+    std::lock_guard lock(m_workersMutex);
+    // compensating worker retires only after the blocking regions end
+    if (!m_threadPoolWorks || m_queuedTasksCount != 0 || worker.compensating ||
+        m_activeWorkersCount - m_compensatingWorkersCount <= m_minThreadsCount)
+        return false;
+
+    EXT_ASSERT(worker.tasks.empty());
+    worker.active = false;
+    --m_activeWorkersCount;
+    ++m_threadsCounters.retiredThreadsCount;
+    return true;
+}
+
+inline bool thread_pool::try_retire_compensating_worker(Worker& worker)
+{
+    std::lock_guard lock(m_workersMutex);
+    if (!m_threadPoolWorks || m_queuedTasksCount != 0 || !worker.compensating ||
+        m_compensatingWorkersCount <= m_blockedWorkersCount)
+        return false;
+
+    EXT_ASSERT(worker.tasks.empty());
+    worker.active = false;
+    worker.compensating = false;
+    --m_activeWorkersCount;
+    --m_compensatingWorkersCount;
+    ++m_threadsCounters.retiredThreadsCount;
+    return true;
+}
+
+inline void thread_pool::on_worker_blocking()
+{
+    std::lock_guard lock(m_workersMutex);
+    ++m_blockedWorkersCount;
+    // threads which replaced previously blocked workers are still working
+    if (!m_threadPoolWorks || m_compensatingWorkersCount >= m_blockedWorkersCount)
+        return;
+
+    try
+    {
+        if (!start_worker(true))
+        {
+            ++m_threadsCounters.maxThreadsReachedCount;
+            return;
+        }
+    }
+    catch (...)
+    {
+        // region works without compensation
+        ext::ManageException(EXT_TRACE_FUNCTION);
+        return;
+    }
+    ++m_compensatingWorkersCount;
+}
+
+inline void thread_pool::on_worker_unblocked()
+{
+    {
+        std::lock_guard lock(m_workersMutex);
+        --m_blockedWorkersCount;
+        if (m_compensatingWorkersCount <= m_blockedWorkersCount)
+            return;
+    }
+
+    // idle compensating worker retires, sleeping worker might check the state and go to sleep right now
+    std::lock_guard lock(m_taskQueueMutex);
+    m_taskQueueChangedNotifier.notify_all();
+}
+
+inline bool thread_pool::has_working_threads()
+{
+    std::lock_guard lock(m_workersMutex);
+    // threads of not active workers might be finishing, check only active ones
+    return m_activeWorkersCount == 0 ? m_elastic :
+        std::any_of(m_workers.begin(), m_workers.end(), [](const Worker& worker)
+        {
+            return worker.active && worker.thread.thread_works();
+        });
+}
+
+inline thread_pool::TaskInfoPtr thread_pool::start_task(TaskInfo* taskInfo, Worker& worker) noexcept
+{
+    // task becomes running before leaving the queue to avoid wait_for_tasks wake up between these states
+    ++m_runningTasksCount;
+    --m_queuedTasksCount;
+    release_queue_places(1);
+
+    taskInfo->worker = &worker;
+    taskInfo->state = TaskState::eRunning;
+    return TaskInfoPtr(taskInfo, TaskInfoDeleter{ this });
+}
+
+inline void thread_pool::take_queued_tasks(TasksList& queue, TasksList& removedTasks) noexcept
+{
+    for (TaskInfo* taskInfo = queue.front(); taskInfo != nullptr; taskInfo = taskInfo->next)
+    {
+        taskInfo->state = TaskState::eFree;
+    }
+    m_queuedTasksCount -= queue.size();
+    release_queue_places(queue.size());
+    removedTasks.splice(queue);
+}
+
+inline void thread_pool::release_task_info(TaskInfo* taskInfo) noexcept
+{
+    if (taskInfo == nullptr)
+        return;
+
+    taskInfo->task.reset();
+    taskInfo->deadline = std::chrono::steady_clock::time_point::max();
+    taskInfo->expired = false;
+    taskInfo->fairQueue = TaskInfo::kNoFairQueue;
+    // make identifier of the task invalid
+    ++taskInfo->generation;
+    taskInfo->state = TaskState::eFree;
+
+    if (Worker* worker = get_current_worker())
+    {
+        worker->freeTasks.push_back(taskInfo);
+        if (worker->freeTasks.size() < kMaxWorkerFreeTasks)
+            return;
+
+        // share cached objects with threads which add tasks to the pool
+        std::lock_guard lock(m_freeTasksMutex);
+        while (worker->freeTasks.size() > kMaxWorkerFreeTasks / 2)
+        {
+            m_freeTasks.push_back(worker->freeTasks.pop_front());
+        }
+        return;
+    }
+
+    std::lock_guard lock(m_freeTasksMutex);
+    m_freeTasks.push_back(taskInfo);
+}
+
+inline void thread_pool::release_tasks(TasksList& tasks) noexcept
+{
+    while (TaskInfo* taskInfo = tasks.pop_front())
+    {
+        release_task_info(taskInfo);
+    }
+}
+
+inline void thread_pool::on_tasks_submitted(std::size_t count) noexcept
+{
+    if (Worker* worker = get_current_worker())
+        MetricsCounters::increase<std::uint64_t>(worker->metrics.submittedTasksCount, count);
+    else
+        m_externalSubmittedTasksCount.fetch_add(count, std::memory_order_relaxed);
+
+    // queued count might be already decreased by workers, high water mark is approximate
+    const std::size_t queuedTasksCount = m_queuedTasksCount.load(std::memory_order_relaxed);
+    std::size_t highWaterMark = m_queueDepthHighWaterMark.load(std::memory_order_relaxed);
+    while (queuedTasksCount > highWaterMark &&
+           !m_queueDepthHighWaterMark.compare_exchange_weak(highWaterMark, queuedTasksCount, std::memory_order_relaxed))
+    {}
+}
+
+inline bool thread_pool::spin_wait_for_tasks() noexcept
+{
+    ++m_spinningWorkersCount;
+
+    bool tasksAppeared = false;
+    thread_details::exponential_wait wait;
+    while (wait.get_step() < m_idleSpinSteps)
+    {
+        if (m_queuedTasksCount != 0 || !m_threadPoolWorks)
+        {
+            tasksAppeared = true;
+            break;
+        }
+        wait();
+    }
+
+    // submitter might already claim this worker, then the counter is decreased by it
+    std::size_t spinningWorkersCount = m_spinningWorkersCount;
+    while (spinningWorkersCount != 0 &&
+           !m_spinningWorkersCount.compare_exchange_weak(spinningWorkersCount, spinningWorkersCount - 1))
+    {}
+    return tasksAppeared;
+}
+
+inline std::size_t thread_pool::claim_spinning_workers(std::size_t count) noexcept
+{
+    std::size_t spinningWorkersCount = m_spinningWorkersCount;
+    std::size_t claimedCount = 0;
+    do
+    {
+        claimedCount = std::min(count, spinningWorkersCount);
+        if (claimedCount == 0)
+            return 0;
+    } while (!m_spinningWorkersCount.compare_exchange_weak(spinningWorkersCount, spinningWorkersCount - claimedCount));
+    return claimedCount;
+}
+
+inline void thread_pool::notify_sleeping_workers(std::size_t count)
+{
+    // spinning workers take tasks without notification
+    count -= claim_spinning_workers(count);
+    if (count == 0 || m_sleepingWorkersCount == 0)
+        return;
+
+    // sleeping worker might check tasks count and go to sleep right now, wait till it releases the mutex
+    { std::lock_guard lock(m_taskQueueMutex); }
+
+    // wake up only workers which will get tasks
+    if (count >= m_sleepingWorkersCount)
+        m_taskQueueChangedNotifier.notify_all();
+    else
+    {
+        for (; count != 0; --count)
+        {
+            m_taskQueueChangedNotifier.notify_one();
+        }
+    }
+}
+
+inline void thread_pool::notify_task_done()
+{
+    if (m_tasksDoneWaitersCount == 0)
+        return;
+
+    { std::lock_guard lock(m_taskQueueMutex); }
+    m_allTasksDoneCv.notify_all();
+}
+
+inline thread_pool::Worker* thread_pool::get_current_worker() const noexcept
+{
+    Worker* worker = current_thread_worker();
+    return worker != nullptr && worker->pool == this ? worker : nullptr;
+}
+
+inline thread_pool::TasksQueue* thread_pool::get_current_thread_queue() const noexcept
+{
+    Worker* worker = get_current_worker();
+    if (worker == nullptr)
+        return nullptr;
+    if (m_workStealing)
+        return worker;
+    return worker->node;
+}
+
+inline thread_pool::Worker*& thread_pool::current_thread_worker() noexcept
+{
+    thread_local Worker* worker = nullptr;
+    return worker;
+}
+
+inline thread_pool::GlobalInstanceSettings& thread_pool::global_instance_settings() noexcept
+{
+    static GlobalInstanceSettings settings;
+    return settings;
+}
+
+inline std::uint64_t thread_pool::DurationHistogram::count() const noexcept
+{
+    std::uint64_t count = 0;
+    for (const auto bucketCount : buckets)
+    {
+        count += bucketCount;
+    }
+    return count;
+}
+
+inline std::chrono::microseconds thread_pool::DurationHistogram::percentile(double percentile) const noexcept
+{
+    const std::uint64_t totalCount = count();
+    if (totalCount == 0)
+        return std::chrono::microseconds(0);
+
+    const auto rank = static_cast<std::uint64_t>(std::clamp(percentile, 0., 1.) * double(totalCount - 1)) + 1;
+    std::uint64_t count = 0;
+    for (std::size_t bucket = 0; bucket < kBucketsCount; ++bucket)
+    {
+        count += buckets[bucket];
+        if (count >= rank)
+            return bucket_upper_bound(bucket);
+    }
+    return bucket_upper_bound(kBucketsCount - 1);
+}
+
+inline std::chrono::microseconds thread_pool::DurationHistogram::bucket_upper_bound(std::size_t bucket) noexcept
+{
+    return std::chrono::microseconds(std::int64_t(1) << bucket);
+}
+
+inline std::size_t thread_pool::DurationHistogram::get_bucket(std::chrono::steady_clock::duration duration) noexcept
+{
+    const auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    if (microseconds <= 0)
+        return 0;
+    return std::min<std::size_t>(thread_pool_details::highest_bit_index(std::uint64_t(microseconds)) + 1, kBucketsCount - 1);
+}
+
+inline thread_pool::DurationHistogram& thread_pool::DurationHistogram::operator+=(const DurationHistogram& other) noexcept
+{
+    for (std::size_t i = 0; i < kBucketsCount; ++i)
+    {
+        buckets[i] += other.buckets[i];
+    }
+    return *this;
+}
+
+inline thread_pool::WorkerMetrics& thread_pool::WorkerMetrics::operator+=(const WorkerMetrics& other) noexcept
+{
+    submittedTasksCount += other.submittedTasksCount;
+    completedTasksCount += other.completedTasksCount;
+    expiredTasksCount += other.expiredTasksCount;
+    stolenTasksCount += other.stolenTasksCount;
+    idleTime += other.idleTime;
+    queueWaitTime += other.queueWaitTime;
+    executionTime += other.executionTime;
+    return *this;
+}
+
+inline blocking_region::blocking_region()
+{
+    thread_pool::Worker* worker = thread_pool::current_thread_worker();
+    if (worker == nullptr || worker->blockingRegionsCount++ != 0)
+        return;
+
+    m_worker = worker;
+    m_worker->pool->on_worker_blocking();
+}
+
+inline blocking_region::~blocking_region()
+{
+    if (m_worker == nullptr)
+    {
+        if (thread_pool::Worker* worker = thread_pool::current_thread_worker())
+            --worker->blockingRegionsCount;
+        return;
+    }
+
+    --m_worker->blockingRegionsCount;
+    m_worker->pool->on_worker_unblocked();
+}
+
+} // namespace ext
+
+template <>
+struct std::hash<ext::thread_pool::TaskId>
+{
+    [[nodiscard]] std::size_t operator()(const ext::thread_pool::TaskId& taskId) const noexcept
+    {
+        return std::hash<std::uint64_t>()((std::uint64_t(taskId.generation) << 32) | taskId.index);
+    }
+};
@@ -26,11 +26,16 @@ Example:
             ... // execute text each 5 minutes
         }
     };
+
+    Async ticks might be executed by the scheduler instead of the own service thread:
+    ::ext::get_singleton<::ext::tick::TickService>().SetAsyncTimerScheduler(&::ext::runtime::GlobalInstance().timer());
 */
 
 #include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 
@@ -45,6 +50,7 @@ Example:
 #include <ext/scope/defer.h>
 
 #include <ext/thread/invoker.h>
+#include <ext/thread/scheduler.h>
 #include <ext/thread/thread.h>
 
 #include <ext/scope/auto_setter.h>
@@ -52,7 +58,11 @@ Example:
 namespace ext::tick {
 
 // tick parameter, passed to the tick handler
+#ifdef _WIN32
 typedef LONG_PTR TickParam;
+#else
+typedef std::intptr_t TickParam;
+#endif // _WIN32
 // type of clock used in the service
 typedef std::chrono::steady_clock tick_clock;
 
@@ -97,6 +107,14 @@ public:
         m_asyncTimer.RemoveHandler(handler, tickParam);
     }
 
+    /// <summary>Execute async ticks by the scheduler instead of the own tick thread,
+    /// allowed only while there are no async handlers.</summary>
+    /// <param name="scheduler">Scheduler pointer, must outlive the service. If null - own tick thread is used.</param>
+    void SetAsyncTimerScheduler(ext::Scheduler* scheduler)
+    {
+        m_asyncTimer.SetScheduler(scheduler);
+    }
+
 #ifdef __AFX_H__
     /// <summary>Add tick handler, OnTick must be called from Invoker thread.</summary>
     /// <param name="handler">Handler pointer.</param>
@@ -300,11 +318,45 @@ private:
 
     struct AsyncTimer : Timer
     {
-        ~AsyncTimer() { if (m_timerWorks) StopTimer(); }
+        ~AsyncTimer()
+        {
+            if (m_timerWorks)
+                StopTimer();
+            // wait for the tick executing by the scheduler
+            if (m_schedulerTickState)
+            {
+                std::scoped_lock lock(m_schedulerTickState->mutex);
+                m_schedulerTickState->timer = nullptr;
+            }
+        }
+
+        void SetScheduler(ext::Scheduler* scheduler)
+        {
+            std::scoped_lock lock(m_handlersMutex);
+            EXT_CHECK(!m_timerWorks) << "Scheduler can't be changed while async handlers exist";
+            m_scheduler = scheduler;
+        }
 
     private:
         void StartTimer() override
         {
+            if (m_scheduler)
+            {
+                if (!m_schedulerTickState)
+                {
+                    m_schedulerTickState = std::make_shared<SchedulerTickState>();
+                    m_schedulerTickState->timer = this;
+                }
+                // scheduler with executor might call the task concurrently, tick is skipped while the previous one works
+                m_schedulerTaskId = m_scheduler->SubscribeTaskByPeriod([state = m_schedulerTickState]()
+                {
+                    std::unique_lock lock(state->mutex, std::try_to_lock);
+                    if (lock.owns_lock() && state->timer)
+                        state->timer->OnTickTimer();
+                }, kDefTickInterval);
+                return;
+            }
+
             EXT_ASSERT(!m_tickThread.joinable());
             m_tickThread.run([&]()
             {
@@ -323,11 +375,29 @@ private:
 
         void StopTimer() override
         {
+            if (m_scheduler)
+            {
+                m_scheduler->RemoveTask(std::exchange(m_schedulerTaskId, ext::kInvalidId));
+                return;
+            }
+
             EXT_ASSERT(m_tickThread.joinable());
             m_tickThread.interrupt_and_join();
         }
+
     private:
+        // state shared with the scheduler task, tick might be executed after the task removal
+        struct SchedulerTickState
+        {
+            std::mutex mutex;
+            AsyncTimer* timer = nullptr;
+        };
+
         ext::thread m_tickThread;
+
+        ext::Scheduler* m_scheduler = nullptr;
+        ext::TaskId m_schedulerTaskId = ext::kInvalidId;
+        std::shared_ptr<SchedulerTickState> m_schedulerTickState;
     } m_asyncTimer;
 };
 
@@ -37,6 +37,8 @@ public:
 
     void done() noexcept {
         if (m_counter.fetch_sub(1) == 1) {
+            // waiter might check the counter and go to sleep right now, wait till it releases the mutex
+            { std::lock_guard<std::mutex> lock(m_mutex); }
             m_cv.notify_all();
         }
     }
@@ -155,8 +155,22 @@ TEST(dispatcher_test, async_call)
     StrictMock<RecipientMock> mock;
     EXPECT_CALL(mock, Event(6));
 
-    ext::send_event_async(&IEvent::Event, 6);
-    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    ext::send_event_async(&IEvent::Event, 6).get();
+}
+
+TEST(dispatcher_test, async_call_order_between_event_signatures)
+{
+    StrictMock<RecipientMock> mock;
+    {
+        InSequence sequence;
+        EXPECT_CALL(mock, Event(1));
+        EXPECT_CALL(mock, EventWithValueObject(_));
+        EXPECT_CALL(mock, Event(2));
+    }
+
+    ext::send_event_async(&IEvent::Event, 1);
+    ext::send_event_async(&IEvent::EventWithValueObject, Counter(kAsyncCounter));
+    ext::send_event_async(&IEvent::Event, 2).get();
 }
 
 TEST(dispatcher_test, async_throwing_exception)
@@ -0,0 +1,40 @@
+#include "allocations_helper.h"
+
+#include <cstdlib>
+#include <new>
+
+#if defined(__GNUC__) && !defined(__clang__)
+// GCC doesn't match the replaced operator delete with the replaced operator new
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace test::allocations {
+
+thread_local int allocations_before_failure = -1;
+thread_local std::size_t allocations_count = 0;
+
+} // namespace test::allocations
+
+void* operator new(std::size_t size) {
+    using namespace test::allocations;
+    if (allocations_before_failure == 0) {
+        allocations_before_failure = -1;
+        throw std::bad_alloc();
+    }
+    if (allocations_before_failure > 0) {
+        --allocations_before_failure;
+    }
+    ++allocations_count;
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
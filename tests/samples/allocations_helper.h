@@ -0,0 +1,13 @@
+#pragma once
+
+// Global operator new replacement for the allocations checks, counters are per thread
+#include <cstddef>
+
+namespace test::allocations {
+
+// count of allocations in the current thread before the failing one, negative if allocations don't fail
+extern thread_local int allocations_before_failure;
+// count of allocations in the current thread
+extern thread_local std::size_t allocations_count;
+
+} // namespace test::allocations
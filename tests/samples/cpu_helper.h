@@ -0,0 +1,28 @@
+#pragma once
+
+// Help functions for the CPU affinity checks
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace test::cpu {
+
+// first cpu of the process affinity mask, tests might be started on a subset of cpus
+inline unsigned get_allowed_cpu()
+{
+#ifdef __linux__
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0)
+    {
+        for (unsigned cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &cpuSet))
+                return cpu;
+        }
+    }
+#endif
+    return 0;
+}
+
+} // namespace test::cpu
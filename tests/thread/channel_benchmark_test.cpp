@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <ext/thread/channel.h>
+#include <ext/thread/mpmc_channel.h>
+
+// Benchmarks are disabled by default, run them with --gtest_also_run_disabled_tests --gtest_filter=*benchmark*
+
+namespace {
+
+constexpr int kElementsCount = 2000000;
+constexpr std::size_t kChannelCapacity = 1024;
+
+// time in microseconds of passing kElementsCount elements from producers to consumers through the channel
+template <typename Channel>
+long long measure(int producersCount, int consumersCount)
+{
+    Channel channel(kChannelCapacity);
+    std::vector<std::thread> threads;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < consumersCount; ++i) {
+        threads.emplace_back([&]()
+            {
+                for ([[maybe_unused]] int val : channel) {
+                }
+            });
+    }
+    std::vector<std::thread> producers;
+    for (int i = 0; i < producersCount; ++i) {
+        producers.emplace_back([&, i]()
+            {
+                for (int val = i; val < kElementsCount; val += producersCount) {
+                    channel.add(val);
+                }
+            });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    channel.close();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+TEST(channel_benchmark, DISABLED_contention)
+{
+    std::cout << std::setw(16) << "producers" << std::setw(16) << "consumers"
+              << std::setw(16) << "Channel(us)" << std::setw(16) << "MpmcChannel(us)" << std::endl;
+    for (const auto& [producers, consumers] : { std::pair{ 1, 1 }, { 2, 2 }, { 4, 4 }, { 8, 8 }, { 8, 1 }, { 1, 8 } }) {
+        std::cout << std::setw(16) << producers << std::setw(16) << consumers
+                  << std::setw(16) << measure<ext::Channel<int>>(producers, consumers)
+                  << std::setw(16) << measure<ext::MpmcChannel<int>>(producers, consumers) << std::endl;
+    }
+}
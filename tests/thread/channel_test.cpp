@@ -1,9 +1,20 @@
 #include "gtest/gtest.h"
 
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
 #include <thread>
+#include <vector>
+
+#include "allocations_helper.h"
 
 #include <ext/scope/defer.h>
 #include <ext/thread/channel.h>
+#include <ext/thread/event.h>
+#include <ext/thread/mpmc_channel.h>
+#include <ext/thread/spsc_channel.h>
 #include <ext/thread/wait_group.h>
 
 TEST(channel_test, check_channel_set_get)
@@ -121,3 +132,461 @@ TEST(channel_test, check_throwing_exceptions)
     channel.close();
     EXPECT_THROW(channel.add(), std::bad_function_call);
 }
+
+TEST(channel_test, check_non_blocking_operations)
+{
+    ext::Channel<int> channel(2);
+    EXPECT_FALSE(channel.try_get().has_value());
+
+    EXPECT_TRUE(channel.try_add(1));
+    EXPECT_TRUE(channel.try_add(2));
+    EXPECT_FALSE(channel.try_add(3));
+
+    EXPECT_EQ(1, *channel.try_get());
+    EXPECT_EQ(2, *channel.try_get());
+    EXPECT_FALSE(channel.try_get().has_value());
+
+    channel.close();
+    EXPECT_THROW((void)channel.try_add(4), std::bad_function_call);
+    EXPECT_FALSE(channel.try_get().has_value());
+}
+
+TEST(channel_test, check_timeouts)
+{
+    ext::Channel<int> channel(1);
+    EXPECT_FALSE(channel.get_for(std::chrono::milliseconds(10)).has_value());
+
+    EXPECT_TRUE(channel.add_for(std::chrono::milliseconds(10), 1));
+    EXPECT_FALSE(channel.add_for(std::chrono::milliseconds(10), 2));
+
+    auto thread = std::thread([&]()
+        {
+            EXPECT_EQ(1, *channel.get());
+        });
+    EXPECT_TRUE(channel.add_for(std::chrono::seconds(10), 2));
+    thread.join();
+
+    EXPECT_EQ(2, *channel.get_for(std::chrono::milliseconds(10)));
+
+    channel.close();
+    EXPECT_THROW((void)channel.add_for(std::chrono::milliseconds(10), 3), std::bad_function_call);
+    EXPECT_FALSE(channel.get_for(std::chrono::seconds(10)).has_value());
+}
+
+TEST(channel_test, check_batches)
+{
+    constexpr int kElementsCount = 1000;
+    ext::Channel<int> channel(16);
+
+    std::vector<int> received;
+    auto thread = std::thread([&]()
+        {
+            std::vector<int> batch;
+            while (const size_t count = channel.get_batch(std::back_inserter(batch), 10)) {
+                EXPECT_LE(count, 10u);
+                EXPECT_EQ(count, batch.size());
+                received.insert(received.end(), batch.begin(), batch.end());
+                batch.clear();
+            }
+        });
+
+    std::vector<int> values(kElementsCount);
+    for (int i = 0; i < kElementsCount; ++i) {
+        values[i] = i;
+    }
+    EXPECT_TRUE(channel.add_range(values.begin(), values.end()) == values.end());
+    channel.close();
+    thread.join();
+
+    EXPECT_EQ(values, received);
+    EXPECT_THROW(channel.add_range(values.begin(), values.end()), std::bad_function_call);
+
+    int value = 0;
+    EXPECT_EQ(0u, channel.get_batch(&value, 1));
+}
+
+TEST(channel_test, check_close_during_add_range)
+{
+    ext::Channel<int> channel(2);
+
+    constexpr int kElementsCount = 100;
+    std::vector<int> values(kElementsCount);
+    for (int i = 0; i < kElementsCount; ++i) {
+        values[i] = i;
+    }
+
+    std::vector<int>::iterator notAdded;
+    auto thread = std::thread([&]()
+        {
+            notAdded = channel.add_range(values.begin(), values.end());
+        });
+
+    std::vector<int> received;
+    for (int i = 0; i < 5; ++i) {
+        received.push_back(*channel.get());
+    }
+    channel.close();
+    thread.join();
+
+    // elements added before closing stay in the channel, add_range returns the first not added element
+    for (int val : channel) {
+        received.push_back(val);
+    }
+    EXPECT_TRUE(notAdded != values.end());
+    EXPECT_EQ(std::vector<int>(values.begin(), notAdded), received);
+}
+
+TEST(channel_test, check_unbounded_channel)
+{
+    ext::Channel<int> channel(ext::Channel<int>::kUnbounded);
+
+    // elements cross the segments borders, drained segments are reused
+    int added = 0;
+    int expected = 0;
+    for (int burst = 0; burst < 10; ++burst) {
+        for (int i = 0; i < 1000; ++i) {
+            EXPECT_TRUE(channel.try_add(added++));
+        }
+        for (int i = 0; i < 700; ++i) {
+            EXPECT_EQ(expected++, *channel.get());
+        }
+    }
+    channel.close();
+    for (int val : channel) {
+        EXPECT_EQ(expected++, val);
+    }
+    EXPECT_EQ(added, expected);
+}
+
+TEST(channel_test, check_unbounded_channel_segments_reuse)
+{
+    ext::Channel<int> channel(ext::Channel<int>::kUnbounded);
+    using queue = ext::channel_details::segmented_queue<int>;
+    constexpr int kBurstSize = int(queue::kSegmentSize * queue::kMaxFreeSegments);
+
+    const auto transfer = [&](int count) {
+        const std::size_t allocationsCount = test::allocations::allocations_count;
+        for (int i = 0; i < count; ++i) {
+            EXPECT_TRUE(channel.try_add(i));
+        }
+        for (int i = 0; i < count; ++i) {
+            EXPECT_EQ(i, *channel.get());
+        }
+        return test::allocations::allocations_count - allocationsCount;
+    };
+
+    // drained segments of the burst are reused by the next bursts
+    EXPECT_NE(0u, transfer(kBurstSize));
+    for (int burst = 0; burst < 10; ++burst) {
+        EXPECT_EQ(0u, transfer(kBurstSize));
+    }
+
+    // segments of the large burst above the free list limit are deleted, the next large burst allocates them again
+    constexpr int kLargeBurstSize = kBurstSize * 10;
+    EXPECT_NE(0u, transfer(kLargeBurstSize));
+    EXPECT_LE(std::size_t(kLargeBurstSize / queue::kSegmentSize - queue::kMaxFreeSegments - 1), transfer(kLargeBurstSize));
+    EXPECT_EQ(0u, transfer(kBurstSize));
+}
+
+TEST(channel_test, check_throwing_element_construction)
+{
+    struct Element {
+        explicit Element(int val) : value(std::make_shared<int>(val)) {
+            if (val < 0) {
+                throw std::invalid_argument("negative");
+            }
+        }
+        std::shared_ptr<int> value;
+    };
+
+    ext::Channel<Element> channel(ext::Channel<Element>::kUnbounded);
+    constexpr size_t kSegmentSize = ext::channel_details::segmented_queue<Element>::kSegmentSize;
+    for (size_t i = 0; i < kSegmentSize; ++i) {
+        channel.add(int(i));
+    }
+    // construction of the first element in the new segment fails
+    EXPECT_THROW(channel.add(-1), std::invalid_argument);
+    channel.add(int(kSegmentSize));
+    channel.close();
+
+    int expected = 0;
+    for (const auto& element : channel) {
+        EXPECT_EQ(expected++, *element.value);
+    }
+    EXPECT_EQ(int(kSegmentSize) + 1, expected);
+}
+
+TEST(spsc_channel_test, check_capacity)
+{
+    EXPECT_EQ(1, ext::SpscChannel<int>(0).capacity());
+    EXPECT_EQ(1, ext::SpscChannel<int>(1).capacity());
+    EXPECT_EQ(4, ext::SpscChannel<int>(3).capacity());
+    EXPECT_EQ(1024, ext::SpscChannel<int>().capacity());
+}
+
+TEST(spsc_channel_test, check_order_with_full_ring)
+{
+    constexpr int kElementsCount = 100000;
+    ext::SpscChannel<int> channel(4);
+
+    auto thread = std::thread([&]()
+        {
+            int expected = 0;
+            for (int val : channel) {
+                EXPECT_EQ(expected++, val);
+            }
+            EXPECT_EQ(kElementsCount, expected);
+        });
+
+    for (int i = 0; i < kElementsCount; ++i) {
+        channel.add(i);
+    }
+    channel.close();
+    thread.join();
+}
+
+TEST(spsc_channel_test, check_parked_consumer_wakes_up)
+{
+    ext::SpscChannel<int> channel(2);
+
+    auto thread = std::thread([&]()
+        {
+            EXPECT_EQ(1, *channel.get());
+            EXPECT_FALSE(channel.get().has_value());
+        });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    channel.add(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    channel.close();
+    thread.join();
+}
+
+TEST(spsc_channel_test, check_closing_wakes_producer)
+{
+    ext::SpscChannel<int> channel(1);
+    channel.add(1);
+
+    auto thread = std::thread([&]()
+        {
+            EXPECT_THROW(channel.add(2), std::bad_function_call);
+        });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    channel.close();
+    thread.join();
+
+    EXPECT_EQ(1, *channel.get());
+    EXPECT_FALSE(channel.get().has_value());
+}
+
+TEST(spsc_channel_test, check_resetting_and_destruction)
+{
+    auto element = std::make_shared<int>(1);
+    {
+        ext::SpscChannel<std::shared_ptr<int>> channel(4);
+        channel.add(element);
+        channel.add(element);
+        EXPECT_EQ(3, element.use_count());
+
+        channel.reset();
+        EXPECT_EQ(1, element.use_count());
+
+        channel.add(element);
+        channel.close();
+        EXPECT_THROW(channel.add(element), std::bad_function_call);
+        EXPECT_EQ(2, element.use_count());
+    }
+    EXPECT_EQ(1, element.use_count());
+}
+
+TEST(spsc_channel_test, check_move_only_elements)
+{
+    ext::SpscChannel<std::unique_ptr<int>> channel(2);
+    channel.add(std::make_unique<int>(1));
+    channel.add(new int(2));
+    channel.close();
+
+    int expected = 1;
+    for (auto& val : channel) {
+        EXPECT_EQ(expected++, *val);
+    }
+    EXPECT_EQ(3, expected);
+}
+
+TEST(mpmc_channel_test, check_capacity)
+{
+    EXPECT_EQ(2, ext::MpmcChannel<int>(1).capacity());
+    EXPECT_EQ(8, ext::MpmcChannel<int>(5).capacity());
+    EXPECT_EQ(1024, ext::MpmcChannel<int>().capacity());
+}
+
+TEST(mpmc_channel_test, check_many_producers_and_consumers)
+{
+    constexpr int kProducersCount = 4;
+    constexpr int kConsumersCount = 4;
+    constexpr int kElementsPerProducer = 20000;
+    ext::MpmcChannel<int> channel(8);
+
+    std::atomic<long long> sum = 0;
+    std::atomic<int> count = 0;
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < kConsumersCount; ++i) {
+        consumers.emplace_back([&]()
+            {
+                for (int val : channel) {
+                    sum += val;
+                    ++count;
+                }
+            });
+    }
+
+    std::vector<std::thread> producers;
+    for (int i = 0; i < kProducersCount; ++i) {
+        producers.emplace_back([&]()
+            {
+                for (int val = 1; val <= kElementsPerProducer; ++val) {
+                    channel.add(val);
+                }
+            });
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    channel.close();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    EXPECT_EQ(kProducersCount * kElementsPerProducer, count);
+    EXPECT_EQ(kProducersCount * (long long)kElementsPerProducer * (kElementsPerProducer + 1) / 2, sum);
+}
+
+namespace {
+
+// element constructed in the claimed cell, construction waits for the gate to fill cells out of order
+struct gated_element {
+    struct gate {
+        ext::Event constructing;
+        ext::Event open;
+    };
+
+    gated_element(int val, gate* cell_gate) noexcept : value(val) {
+        if (cell_gate != nullptr) {
+            cell_gate->constructing.RaiseAll();
+            cell_gate->open.Wait();
+        }
+    }
+
+    int value;
+};
+
+} // namespace
+
+TEST(mpmc_channel_test, check_waking_consumers_on_out_of_order_adding)
+{
+    ext::MpmcChannel<gated_element> channel(8);
+
+    // each consumer gets one element, so the consumer of the first cell doesn't take the second one
+    std::atomic<int> sum = 0;
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 2; ++i) {
+        consumers.emplace_back([&]()
+            {
+                if (auto element = channel.get()) {
+                    sum += element->value;
+                }
+            });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    // the second cell is filled first, its wake up finds the first cell empty
+    gated_element::gate gate;
+    std::thread producer([&]() { channel.add(1, &gate); });
+    ASSERT_TRUE(gate.constructing.Wait(std::chrono::seconds(1)));
+    channel.add(2, nullptr);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    gate.open.RaiseAll();
+    producer.join();
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (sum != 3 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(3, sum);
+
+    channel.close();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+}
+
+TEST(mpmc_channel_test, check_closing_wakes_waiters)
+{
+    ext::MpmcChannel<int> channel(2);
+
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 3; ++i) {
+        consumers.emplace_back([&]()
+            {
+                EXPECT_FALSE(channel.get().has_value());
+            });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    channel.close();
+    for (auto& consumer : consumers) {
+        consumer.join();
+    }
+
+    channel.reset();
+    channel.add(1);
+    channel.add(2);
+    std::vector<std::thread> producers;
+    for (int i = 0; i < 3; ++i) {
+        producers.emplace_back([&]()
+            {
+                EXPECT_THROW(channel.add(3), std::bad_function_call);
+            });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    channel.close();
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_EQ(1, *channel.get());
+    EXPECT_EQ(2, *channel.get());
+    EXPECT_FALSE(channel.get().has_value());
+    EXPECT_THROW(channel.add(4), std::bad_function_call);
+}
+
+TEST(mpmc_channel_test, check_resetting_and_destruction)
+{
+    auto element = std::make_shared<int>(1);
+    {
+        ext::MpmcChannel<std::shared_ptr<int>> channel(4);
+        channel.add(element);
+        channel.add(element);
+        EXPECT_EQ(3, element.use_count());
+
+        channel.reset();
+        EXPECT_EQ(1, element.use_count());
+
+        channel.add(element);
+        channel.close();
+        EXPECT_EQ(2, element.use_count());
+    }
+    EXPECT_EQ(1, element.use_count());
+
+    ext::MpmcChannel<std::unique_ptr<int>> channel(2);
+    channel.add(std::make_unique<int>(1));
+    channel.add(new int(2));
+    channel.close();
+
+    int expected = 1;
+    for (auto& val : channel) {
+        EXPECT_EQ(expected++, *val);
+    }
+    EXPECT_EQ(3, expected);
+}
@@ -0,0 +1,125 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+// libstdc++ parallel algorithms require TBB, tests CMakeLists defines EXT_STD_PARALLEL_ALGORITHMS if it is found
+#if defined(_MSC_VER) && !defined(EXT_STD_PARALLEL_ALGORITHMS)
+#define EXT_STD_PARALLEL_ALGORITHMS
+#endif
+
+#ifdef EXT_STD_PARALLEL_ALGORITHMS
+#include <execution>
+#endif
+
+#include <ext/thread/parallel.h>
+
+// Benchmarks are disabled by default, run them with --gtest_also_run_disabled_tests --gtest_filter=*benchmark*
+
+namespace {
+
+constexpr std::size_t kElementsCount = 10000000;
+
+std::vector<double> generate_values()
+{
+    std::vector<double> values(kElementsCount);
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(-1000., 1000.);
+    std::generate(values.begin(), values.end(), [&]() { return distribution(generator); });
+    return values;
+}
+
+template <typename Function>
+long long measure(Function&& function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void print_header()
+{
+    std::cout << std::setw(16) << "algorithm" << std::setw(16) << "serial(us)" << std::setw(16) << "ext(us)"
+#ifdef EXT_STD_PARALLEL_ALGORITHMS
+              << std::setw(16) << "std::par(us)"
+#endif
+              << std::endl;
+}
+
+// prints execution time of the serial, ext::parallel and std::execution::par versions of the algorithm
+template <typename Serial, typename Parallel, typename StdParallel>
+void print_results(const char* name, const std::vector<double>& source,
+                   Serial&& serial, Parallel&& parallel, [[maybe_unused]] StdParallel&& stdParallel)
+{
+    auto values = source;
+    std::cout << std::setw(16) << name << std::setw(16) << measure([&]() { serial(values); });
+    values = source;
+    std::cout << std::setw(16) << measure([&]() { parallel(values); });
+#ifdef EXT_STD_PARALLEL_ALGORITHMS
+    values = source;
+    std::cout << std::setw(16) << measure([&]() { stdParallel(values); });
+#endif
+    std::cout << std::endl;
+}
+
+} // namespace
+
+TEST(parallel_benchmark, DISABLED_algorithms)
+{
+    const auto source = generate_values();
+    std::vector<double> result(source.size());
+    volatile double sum = 0;
+
+    print_header();
+    print_results("for_each", source,
+        [](auto& values) { std::for_each(values.begin(), values.end(), [](double& value) { value = std::sqrt(std::abs(value)); }); },
+        [](auto& values) { ext::parallel::for_each(values.begin(), values.end(), [](double& value) { value = std::sqrt(std::abs(value)); }); },
+        [](auto& values)
+        {
+#ifdef EXT_STD_PARALLEL_ALGORITHMS
+            std::for_each(std::execution::par, values.begin(), values.end(), [](double& value) { value = std::sqrt(std::abs(value)); });
+#endif
+        });
+    print_results("transform", source,
+        [&](auto& values) { std::transform(values.begin(), values.end(), result.begin(), [](double value) { return std::sin(value); }); },
+        [&](auto& values) { ext::parallel::transform(values.begin(), values.end(), result.begin(), [](double value) { return std::sin(value); }); },
+        [&](auto& values)
+        {
+#ifdef EXT_STD_PARALLEL_ALGORITHMS
+            std::transform(std::execution::par, values.begin(), values.end(), result.begin(), [](double value) { return std::sin(value); });
+#endif
+        });
+    print_results("reduce", source,
+        [&](auto& values) { sum = std::reduce(values.begin(), values.end()); },
+        [&](auto& values) { sum = ext::parallel::reduce(values.begin(), values.end()); },
+        [&](auto& values)
+        {
+#ifdef EXT_STD_PARALLEL_ALGORITHMS
+            sum = std::reduce(std::execution::par, values.begin(), values.end());
+#endif
+        });
+    print_results("inclusive_scan", source,
+        [&](auto& values) { std::inclusive_scan(values.begin(), values.end(), result.begin()); },
+        [&](auto& values) { ext::parallel::inclusive_scan(values.begin(), values.end(), result.begin()); },
+        [&](auto& values)
+        {
+#ifdef EXT_STD_PARALLEL_ALGORITHMS
+            std::inclusive_scan(std::execution::par, values.begin(), values.end(), result.begin());
+#endif
+        });
+    print_results("sort", source,
+        [](auto& values) { std::sort(values.begin(), values.end()); },
+        [](auto& values) { ext::parallel::sort(values.begin(), values.end()); },
+        [](auto& values)
+        {
+#ifdef EXT_STD_PARALLEL_ALGORITHMS
+            std::sort(std::execution::par, values.begin(), values.end());
+#endif
+        });
+}
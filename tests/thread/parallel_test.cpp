@@ -0,0 +1,180 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <ext/thread/parallel.h>
+#include <ext/thread/thread_pool.h>
+
+namespace {
+
+std::vector<int> generate_values(std::size_t size)
+{
+    std::vector<int> values(size);
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> distribution(-1000, 1000);
+    std::generate(values.begin(), values.end(), [&]() { return distribution(generator); });
+    return values;
+}
+
+} // namespace
+
+TEST(parallel_test, for_each)
+{
+    ext::thread_pool threadPool(4);
+    const ext::parallel::Options options{ .threadPool = &threadPool };
+
+    for (std::size_t size : { 0, 1, 7, 1000, 100000 })
+    {
+        std::vector<int> values(size, 1);
+        ext::parallel::for_each(options, values.begin(), values.end(), [](int& value) { value *= 3; });
+        EXPECT_TRUE(std::all_of(values.begin(), values.end(), [](int value) { return value == 3; })) << size;
+    }
+
+    std::vector<std::atomic_int> counters(1000);
+    ext::parallel::for_each(counters.begin(), counters.end(), [](std::atomic_int& counter) { ++counter; });
+    EXPECT_TRUE(std::all_of(counters.begin(), counters.end(), [](const std::atomic_int& counter) { return counter == 1; }));
+}
+
+TEST(parallel_test, transform)
+{
+    ext::thread_pool threadPool(4);
+    const ext::parallel::Options options{ .threadPool = &threadPool, .minChunkSize = 16 };
+
+    const auto values = generate_values(10000);
+    std::vector<std::string> result(values.size());
+    const auto end = ext::parallel::transform(options, values.begin(), values.end(), result.begin(),
+                                              [](int value) { return std::to_string(value); });
+    EXPECT_EQ(end, result.end());
+
+    std::vector<std::string> expected(values.size());
+    std::transform(values.begin(), values.end(), expected.begin(), [](int value) { return std::to_string(value); });
+    EXPECT_EQ(result, expected);
+
+    // in place transformation
+    auto inPlace = values;
+    ext::parallel::transform(inPlace.begin(), inPlace.end(), inPlace.begin(), [](int value) { return value * 2; });
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        ASSERT_EQ(inPlace[i], values[i] * 2);
+    }
+}
+
+TEST(parallel_test, reduce)
+{
+    ext::thread_pool threadPool(4);
+    const ext::parallel::Options options{ .threadPool = &threadPool };
+
+    for (std::size_t size : { 0, 1, 3, 1000, 100000 })
+    {
+        const auto values = generate_values(size);
+        EXPECT_EQ(ext::parallel::reduce(options, values.begin(), values.end(), 10),
+                  std::accumulate(values.begin(), values.end(), 10)) << size;
+    }
+
+    const auto values = generate_values(1000);
+    EXPECT_EQ(ext::parallel::reduce(values.begin(), values.end()), std::accumulate(values.begin(), values.end(), 0));
+    EXPECT_EQ(ext::parallel::reduce(values.begin(), values.end(), std::numeric_limits<int>::min(),
+                                    [](int left, int right) { return std::max(left, right); }),
+              *std::max_element(values.begin(), values.end()));
+}
+
+TEST(parallel_test, inclusive_scan)
+{
+    ext::thread_pool threadPool(3);
+    const ext::parallel::Options options{ .threadPool = &threadPool };
+
+    for (std::size_t size : { 0, 1, 2, 15, 1000, 100001 })
+    {
+        const auto values = generate_values(size);
+        std::vector<long long> expected(size), result(size);
+        std::inclusive_scan(values.begin(), values.end(), expected.begin(), std::plus<long long>());
+
+        EXPECT_EQ(ext::parallel::inclusive_scan(options, values.begin(), values.end(), result.begin(),
+                                                std::plus<long long>()), result.end());
+        EXPECT_EQ(result, expected) << size;
+    }
+
+    auto values = generate_values(5000);
+    std::vector<int> expected(values.size());
+    std::inclusive_scan(values.begin(), values.end(), expected.begin());
+    ext::parallel::inclusive_scan(values.begin(), values.end(), values.begin());
+    EXPECT_EQ(values, expected);
+}
+
+TEST(parallel_test, sort)
+{
+    ext::thread_pool threadPool(4);
+    const ext::parallel::Options options{ .threadPool = &threadPool };
+
+    for (std::size_t size : { 0, 1, 2, 100, 10000, 100000 })
+    {
+        auto values = generate_values(size);
+        auto expected = values;
+        std::sort(expected.begin(), expected.end());
+
+        ext::parallel::sort(options, values.begin(), values.end());
+        EXPECT_EQ(values, expected) << size;
+    }
+
+    auto values = generate_values(50000);
+    ext::parallel::sort(values.begin(), values.end(), std::greater<>());
+    EXPECT_TRUE(std::is_sorted(values.begin(), values.end(), std::greater<>()));
+}
+
+TEST(parallel_test, exception)
+{
+    ext::thread_pool threadPool(4);
+    const ext::parallel::Options options{ .threadPool = &threadPool, .minChunkSize = 1 };
+
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+
+    std::atomic_int executedCount = 0;
+    EXPECT_THROW(ext::parallel::for_each(options, values.begin(), values.end(), [&](int value)
+    {
+        if (value == 10)
+            throw std::runtime_error("Error");
+        ++executedCount;
+    }), std::runtime_error);
+    EXPECT_LT(executedCount, 1000);
+
+    // pool is still usable
+    EXPECT_EQ(ext::parallel::reduce(options, values.begin(), values.end()), 999 * 1000 / 2);
+}
+
+TEST(parallel_test, cancellation)
+{
+    ext::thread_pool threadPool(2);
+    ext::stop_source stopSource;
+    const ext::parallel::Options options{ .threadPool = &threadPool, .stopToken = stopSource.get_token(), .minChunkSize = 1 };
+
+    std::vector<int> values(10000);
+    std::atomic_int executedCount = 0;
+    EXPECT_THROW(ext::parallel::for_each(options, values.begin(), values.end(), [&](int)
+    {
+        if (++executedCount == 100)
+            stopSource.request_stop();
+    }), ext::thread::thread_interrupted);
+    EXPECT_LT(executedCount, 10000);
+
+    EXPECT_THROW(ext::parallel::sort(options, values.begin(), values.end()), ext::thread::thread_interrupted);
+}
+
+TEST(parallel_test, call_from_pool_worker)
+{
+    // the calling worker executes all chunks itself when there are no free workers
+    ext::thread_pool threadPool(1);
+    const ext::parallel::Options options{ .threadPool = &threadPool };
+
+    auto result = threadPool.add_task([&]()
+    {
+        std::vector<int> values(10000, 1);
+        return ext::parallel::reduce(options, values.begin(), values.end());
+    });
+    EXPECT_EQ(result.second.get(), 10000);
+}
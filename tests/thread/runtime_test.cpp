@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <optional>
+#include <thread>
+
+#include <ext/core/check.h>
+#include <ext/scope/defer.h>
+#include <ext/thread/event.h>
+#include <ext/thread/runtime.h>
+#include <ext/thread/tick.h>
+
+TEST(runtime_test, executors)
+{
+    ext::runtime runtime(ext::runtime::Options{ .threadsCount = 2, .maxBlockingThreadsCount = 4 });
+    EXPECT_EQ(runtime.cpu_pool().threads_count(), 2u);
+
+    EXPECT_EQ(runtime.cpu_pool().add_task([]() { return 1; }).second.get(), 1);
+
+    // blocking tasks don't wait for each other
+    ext::Event continueExecution;
+    // release the blocking tasks if the test fails, runtime destruction waits for them
+    EXT_DEFER(continueExecution.RaiseAll());
+    std::atomic_int startedCount = 0;
+    std::future<void> blockingTasks[4];
+    for (auto& task : blockingTasks)
+    {
+        task = runtime.blocking_pool().add_task([&]()
+        {
+            ++startedCount;
+            continueExecution.Wait();
+        }).second;
+    }
+    const auto waitEnd = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (startedCount != 4 && std::chrono::steady_clock::now() < waitEnd)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(startedCount, 4) << "blocking pool didn't start a thread for each blocking task";
+    EXPECT_EQ(runtime.blocking_pool().get_threads_counters().threadsCount, 4u);
+    continueExecution.RaiseAll();
+    for (auto& task : blockingTasks)
+    {
+        task.get();
+    }
+
+    ext::serial_lane lane = runtime.make_serial_lane();
+    EXPECT_EQ(lane.add_task([]() { return 2; }).get(), 2);
+}
+
+TEST(runtime_test, timer_executes_tasks_in_cpu_pool)
+{
+    ext::runtime runtime(ext::runtime::Options{ .threadsCount = 1 });
+
+    std::promise<std::thread::id> executionThread;
+    std::promise<std::thread::id> cpuPoolThread;
+    runtime.cpu_pool().add_task([&]() { cpuPoolThread.set_value(std::this_thread::get_id()); });
+    runtime.timer().SubscribeTaskAtTime([&]() { executionThread.set_value(std::this_thread::get_id()); },
+                                        std::chrono::system_clock::now() + std::chrono::milliseconds(10));
+    EXPECT_EQ(executionThread.get_future().get(), cpuPoolThread.get_future().get());
+}
+
+TEST(runtime_test, tick_service_on_runtime_timer)
+{
+    ext::runtime runtime(ext::runtime::Options{ .threadsCount = 1 });
+    std::promise<std::thread::id> cpuPoolThread;
+    runtime.cpu_pool().add_task([&]() { cpuPoolThread.set_value(std::this_thread::get_id()); });
+
+    struct TickHandler : ext::tick::ITickHandler
+    {
+        void OnTick(ext::tick::TickParam) noexcept override
+        {
+            tickThread = std::this_thread::get_id();
+            ++ticksCount;
+            tickStarted.RaiseAll();
+            if (tickDuration.count() != 0)
+            {
+                std::this_thread::sleep_for(tickDuration);
+                tickFinished = true;
+            }
+        }
+
+        std::atomic<std::thread::id> tickThread;
+        std::atomic_int ticksCount = 0;
+        ext::Event tickStarted;
+        std::chrono::milliseconds tickDuration = std::chrono::milliseconds(0);
+        std::atomic_bool tickFinished = false;
+    } handler;
+
+    std::optional<ext::tick::TickService> tickService(std::in_place);
+    tickService->SetAsyncTimerScheduler(&runtime.timer());
+
+    // ticks are executed by the CPU pool
+    tickService->SubscribeAsync(&handler, std::chrono::milliseconds(0));
+    ASSERT_TRUE(handler.tickStarted.Wait(std::chrono::seconds(5)));
+    EXPECT_EQ(handler.tickThread.load(), cpuPoolThread.get_future().get());
+
+    EXPECT_THROW(tickService->SetAsyncTimerScheduler(nullptr), ext::check::CheckFailedException);
+
+    // removing the last handler stops the ticks, wait for the tick which might be executing now
+    tickService->UnsubscribeAsync(&handler);
+    std::this_thread::sleep_for(ext::tick::TickService::kDefTickInterval);
+    const int ticksCount = handler.ticksCount;
+    std::this_thread::sleep_for(ext::tick::TickService::kDefTickInterval * 3);
+    EXPECT_EQ(handler.ticksCount, ticksCount);
+    EXPECT_NO_THROW(tickService->SetAsyncTimerScheduler(&runtime.timer()));
+
+    // service destruction waits for the executing tick
+    handler.tickDuration = std::chrono::milliseconds(100);
+    handler.tickStarted.Reset();
+    tickService->SubscribeAsync(&handler, std::chrono::milliseconds(0));
+    ASSERT_TRUE(handler.tickStarted.Wait(std::chrono::seconds(5)));
+    tickService.reset();
+    EXPECT_TRUE(handler.tickFinished);
+}
+
+TEST(runtime_test, global_instance)
+{
+    // global pool is used before the runtime, configuration fails in the caller and doesn't break the runtime
+    EXT_IGNORE_RESULT(ext::thread_pool::GlobalInstance());
+    EXPECT_THROW(ext::runtime::ConfigureGlobalInstance(ext::runtime::Options{ .threadsCount = 1 }),
+                 ext::check::CheckFailedException);
+
+    ext::runtime& runtime = ext::runtime::GlobalInstance();
+    EXPECT_EQ(&runtime, &ext::runtime::GlobalInstance());
+    // global pool users share the runtime threads
+    EXPECT_EQ(&runtime.cpu_pool(), &ext::thread_pool::GlobalInstance());
+
+    EXPECT_THROW(ext::runtime::ConfigureGlobalInstance(ext::runtime::Options{ .threadsCount = 1 }),
+                 ext::check::CheckFailedException);
+    EXPECT_THROW(ext::thread_pool::ConfigureGlobalInstance(ext::thread_pool::Options{ .threadsCount = 1 }),
+                 ext::check::CheckFailedException);
+}
@@ -1,9 +1,13 @@
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <chrono>
+#include <future>
+#include <memory>
 #include <optional>
 
 #include <ext/thread/scheduler.h>
+#include <ext/thread/thread_pool.h>
 
 TEST(scheduler_test, check_scheduling_tasks)
 {
@@ -111,4 +115,54 @@ TEST(scheduler_test, check_scheduling_multiple_tasks)
     std::this_thread::sleep_for(std::chrono::milliseconds(400));
     EXPECT_TRUE(executedFirstTask);
     EXPECT_TRUE(executedSecondTask);
-}
\ No newline at end of file
+}
+
+TEST(scheduler_test, watchdog)
+{
+    ext::Scheduler scheduler;
+    scheduler.EnableWatchdog(std::chrono::milliseconds(10));
+
+    std::promise<void> taskDone;
+    scheduler.SubscribeTaskAtTime(
+        [&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            taskDone.set_value();
+        },
+        std::chrono::system_clock::now() + std::chrono::milliseconds(1));
+    taskDone.get_future().get();
+    EXPECT_EQ(scheduler.GetHungTasksCount(), 1u);
+}
+
+TEST(scheduler_test, executor_periodic_task)
+{
+    ext::thread_pool threadPool(4);
+    auto scheduler = std::make_unique<ext::Scheduler>(threadPool);
+
+    // task is longer than its period, calls are skipped while the previous call is executing
+    std::atomic_int runningCalls = 0;
+    std::atomic_int maxRunningCalls = 0;
+    std::atomic_int callsCount = 0;
+    scheduler->SubscribeTaskByPeriod(
+        [&]()
+        {
+            const int running = ++runningCalls;
+            if (running > maxRunningCalls)
+                maxRunningCalls = running;
+            std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            ++callsCount;
+            --runningCalls;
+        },
+        std::chrono::milliseconds(5));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    // destruction waits for the call passed to the pool
+    scheduler.reset();
+    const int callsAfterDestruction = callsCount;
+    EXPECT_EQ(runningCalls, 0);
+    EXPECT_EQ(maxRunningCalls, 1);
+    EXPECT_GT(callsAfterDestruction, 1);
+
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(callsCount, callsAfterDestruction);
+}
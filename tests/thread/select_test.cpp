@@ -0,0 +1,147 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <new>
+#include <optional>
+#include <string>
+#include <thread>
+
+#include "allocations_helper.h"
+
+#include <ext/thread/select.h>
+
+TEST(select_test, check_ready_channel)
+{
+    ext::Channel<int> numbers;
+    ext::Channel<std::string> names;
+    names.add("name");
+
+    std::optional<std::string> received;
+    const size_t index = ext::select(
+        ext::receive_case(numbers, [](std::optional<int>) { FAIL() << "Channel is empty"; }),
+        ext::receive_case(names, [&](std::optional<std::string> name) { received = std::move(name); }));
+    EXPECT_EQ(1u, index);
+    EXPECT_EQ("name", received);
+}
+
+TEST(select_test, check_default_case)
+{
+    ext::Channel<int> numbers;
+    bool executed = false;
+    EXPECT_EQ(1u, ext::select(
+        ext::receive_case(numbers, [](std::optional<int>) { FAIL() << "Channel is empty"; }),
+        ext::default_case([&]() { executed = true; })));
+    EXPECT_TRUE(executed);
+
+    numbers.add(1);
+    EXPECT_EQ(0u, ext::select(
+        ext::receive_case(numbers, [](std::optional<int> number) { EXPECT_EQ(1, number); }),
+        ext::default_case([]() { FAIL() << "Channel is ready"; })));
+}
+
+TEST(select_test, check_timeout_case)
+{
+    ext::Channel<int> numbers;
+    bool timeout = false;
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(0u, ext::select(
+        ext::timeout_case(std::chrono::milliseconds(50), [&]() { timeout = true; }),
+        ext::receive_case(numbers, [](std::optional<int>) { FAIL() << "Channel is empty"; })));
+    EXPECT_TRUE(timeout);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(50));
+}
+
+TEST(select_test, check_waiting)
+{
+    ext::Channel<int> numbers;
+    ext::Channel<int> results(1);
+    results.add(0);
+
+    auto thread = std::thread([&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            numbers.add(10);
+        });
+
+    std::optional<int> received;
+    EXPECT_EQ(0u, ext::select(
+        ext::receive_case(numbers, [&](std::optional<int> number) { received = number; }),
+        ext::send_case(results, 1, []() { FAIL() << "Channel is full"; })));
+    EXPECT_EQ(10, received);
+    thread.join();
+
+    thread = std::thread([&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            EXPECT_EQ(0, *results.get());
+        });
+    bool sent = false;
+    EXPECT_EQ(1u, ext::select(
+        ext::receive_case(numbers, [](std::optional<int>) { FAIL() << "Channel is empty"; }),
+        ext::send_case(results, 1, [&]() { sent = true; })));
+    EXPECT_TRUE(sent);
+    EXPECT_EQ(1, *results.get());
+    thread.join();
+}
+
+TEST(select_test, check_closed_channels)
+{
+    ext::Channel<int> numbers;
+    auto thread = std::thread([&]()
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            numbers.close();
+        });
+
+    bool closed = false;
+    EXPECT_EQ(0u, ext::select(
+        ext::receive_case(numbers, [&](std::optional<int> number) { closed = !number.has_value(); })));
+    EXPECT_TRUE(closed);
+    thread.join();
+
+    EXPECT_THROW(ext::select(ext::send_case(numbers, 1, []() {})), std::bad_function_call);
+}
+
+TEST(select_test, check_fairness)
+{
+    ext::Channel<int> first(100);
+    ext::Channel<int> second(100);
+    for (int i = 0; i < 100; ++i) {
+        first.add(i);
+        second.add(i);
+    }
+
+    size_t selected[2] = { 0, 0 };
+    for (int i = 0; i < 100; ++i) {
+        ++selected[ext::select(
+            ext::receive_case(first, [](std::optional<int>) {}),
+            ext::receive_case(second, [](std::optional<int>) {}))];
+    }
+    EXPECT_GT(selected[0], 20u);
+    EXPECT_GT(selected[1], 20u);
+}
+
+TEST(select_test, check_registration_failure)
+{
+    ext::Channel<int> numbers;
+    ext::Channel<std::string> names;
+    // first select initializes the thread random generator
+    ext::select(
+        ext::receive_case(numbers, [](std::optional<int>) {}),
+        ext::default_case([]() {}));
+
+    // the first channel registers the waiter, the second one fails to store it
+    test::allocations::allocations_before_failure = 1;
+    EXPECT_THROW(ext::select(
+        ext::receive_case(numbers, [](std::optional<int>) { FAIL() << "Channel is empty"; }),
+        ext::receive_case(names, [](std::optional<std::string>) { FAIL() << "Channel is empty"; })),
+        std::bad_alloc);
+    EXPECT_EQ(-1, test::allocations::allocations_before_failure);
+
+    // channels must not notify the waiter of the failed select
+    numbers.add(1);
+    names.add("name");
+    std::optional<int> received;
+    EXPECT_EQ(0u, ext::select(ext::receive_case(numbers, [&](std::optional<int> number) { received = number; })));
+    EXPECT_EQ(1, received);
+}
@@ -0,0 +1,197 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <ext/thread/event.h>
+#include <ext/thread/serial_lane.h>
+#include <ext/thread/thread.h>
+#include <ext/thread/thread_pool.h>
+
+TEST(serial_lane_test, tasks_order)
+{
+    ext::thread_pool threadPool(4);
+    ext::serial_lane lane(threadPool);
+
+    std::vector<int> executionOrder;
+    std::atomic_int runningTasks = 0;
+    for (int i = 0; i < 200; ++i)
+    {
+        lane.add_task_detached([&](int value)
+        {
+            // lane tasks never run concurrently
+            EXPECT_EQ(++runningTasks, 1);
+            executionOrder.emplace_back(value);
+            --runningTasks;
+        }, i);
+    }
+    lane.wait();
+
+    ASSERT_EQ(executionOrder.size(), 200u);
+    for (int i = 0; i < 200; ++i)
+    {
+        EXPECT_EQ(executionOrder[i], i);
+    }
+    EXPECT_EQ(lane.tasks_count(), 0u);
+}
+
+TEST(serial_lane_test, futures)
+{
+    ext::thread_pool threadPool(2);
+    ext::serial_lane lane(threadPool);
+
+    std::future<int> result = lane.add_task([](int value) { return value * 2; }, 21);
+    std::future<void> exception = lane.add_task([]() { throw std::runtime_error("lane task"); });
+    EXPECT_EQ(result.get(), 42);
+    EXPECT_THROW(exception.get(), std::runtime_error);
+
+    // lane continues after the task exception
+    EXPECT_EQ(lane.add_task([]() { return 1; }).get(), 1);
+}
+
+TEST(serial_lane_test, lanes_share_pool)
+{
+    ext::thread_pool threadPool(2);
+    ext::serial_lane firstLane(threadPool);
+    ext::serial_lane secondLane(threadPool);
+
+    // blocked lane occupies only one worker, the other lane works
+    ext::Event continueExecution;
+    firstLane.add_task_detached([&]() { continueExecution.Wait(); });
+    std::future<int> firstLaneResult = firstLane.add_task([]() { return 1; });
+    EXPECT_EQ(secondLane.add_task([]() { return 2; }).get(), 2);
+    EXPECT_EQ(firstLane.tasks_count(), 2u);
+
+    continueExecution.RaiseAll();
+    EXPECT_EQ(firstLaneResult.get(), 1);
+    firstLane.wait();
+    EXPECT_EQ(firstLane.tasks_count(), 0u);
+}
+
+TEST(serial_lane_test, tasks_after_lane_destruction)
+{
+    ext::thread_pool threadPool(1);
+
+    ext::Event continueExecution;
+    std::atomic_int executedCount = 0;
+    {
+        ext::serial_lane lane(threadPool);
+        lane.add_task_detached([&]() { continueExecution.Wait(); });
+        for (int i = 0; i < 100; ++i)
+        {
+            lane.add_task_detached([&]() { ++executedCount; });
+        }
+    }
+    continueExecution.RaiseAll();
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(executedCount, 100);
+}
+
+TEST(serial_lane_test, tasks_after_pool_destruction)
+{
+    auto threadPool = std::make_unique<ext::thread_pool>(1);
+    ext::serial_lane lane(*threadPool);
+
+    // worker is busy, lane pool task stays queued till the pool destruction
+    std::atomic_bool workerStarted = false;
+    threadPool->add_task_detached([&]()
+    {
+        workerStarted = true;
+        const auto token = ext::this_thread::get_stop_token();
+        while (!token.stop_requested())
+        {
+            ext::this_thread::yield();
+        }
+    });
+    while (!workerStarted)
+    {
+        std::this_thread::yield();
+    }
+
+    // more tasks than one lane turn executes, lane is not rescheduled into the destroyed pool
+    std::atomic_int executedCount = 0;
+    for (int i = 0; i < 100; ++i)
+    {
+        lane.add_task_detached([&]() { ++executedCount; });
+    }
+    threadPool.reset();
+
+    EXPECT_EQ(executedCount, 100);
+    EXPECT_EQ(lane.tasks_count(), 0u);
+    lane.wait();
+}
+
+TEST(serial_lane_test, bounded_pool_overflow_policies)
+{
+    for (const auto overflowPolicy : { ext::thread_pool::OverflowPolicy::eBlock,
+                                       ext::thread_pool::OverflowPolicy::eReject,
+                                       ext::thread_pool::OverflowPolicy::eCallerRuns,
+                                       ext::thread_pool::OverflowPolicy::eDropOldest })
+    {
+        SCOPED_TRACE(static_cast<int>(overflowPolicy));
+
+        ext::thread_pool threadPool(ext::thread_pool::Options{
+            .threadsCount = 1, .queueCapacity = 1, .overflowPolicy = overflowPolicy });
+        ext::serial_lane lane(threadPool);
+
+        // lane tasks fill the pool queue, so the lane continues after each turn in the full pool
+        std::vector<int> executionOrder;
+        std::atomic_int runningTasks = 0;
+        for (int i = 0; i < 200; ++i)
+        {
+            lane.add_task_detached([&](int value)
+            {
+                EXPECT_EQ(++runningTasks, 1);
+                try
+                {
+                    threadPool.add_task_detached([]() {});
+                }
+                catch (const ext::thread_pool::queue_overflow&)
+                {}
+                executionOrder.emplace_back(value);
+                --runningTasks;
+            }, i);
+        }
+        lane.wait();
+
+        ASSERT_EQ(executionOrder.size(), 200u);
+        for (int i = 0; i < 200; ++i)
+        {
+            EXPECT_EQ(executionOrder[i], i);
+        }
+        EXPECT_EQ(lane.tasks_count(), 0u);
+        threadPool.wait_for_tasks();
+    }
+}
+
+TEST(serial_lane_test, full_pool_caller_runs)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{
+        .threadsCount = 1, .queueCapacity = 1, .overflowPolicy = ext::thread_pool::OverflowPolicy::eCallerRuns });
+
+    ext::Event taskStarted, continueExecution;
+    threadPool.add_task_detached([&]()
+    {
+        taskStarted.RaiseAll();
+        continueExecution.Wait();
+    });
+    ASSERT_TRUE(taskStarted.Wait(std::chrono::seconds(1)));
+    threadPool.add_task_detached([]() {});
+
+    // full pool executes the lane in the adding thread
+    ext::serial_lane lane(threadPool);
+    EXPECT_EQ(lane.add_task([]() { return std::this_thread::get_id(); }).get(), std::this_thread::get_id());
+    EXPECT_EQ(lane.tasks_count(), 0u);
+
+    // moved lane has no tasks
+    ext::serial_lane movedLane(std::move(lane));
+    EXPECT_EQ(lane.tasks_count(), 0u);
+
+    continueExecution.RaiseAll();
+    threadPool.wait_for_tasks();
+}
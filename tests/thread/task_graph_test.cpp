@@ -0,0 +1,310 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <ext/thread/event.h>
+#include <ext/thread/task_graph.h>
+#include <ext/thread/thread.h>
+#include <ext/thread/thread_pool.h>
+
+namespace {
+
+// occupy the only pool worker till the release or the interruption
+void block_worker(ext::thread_pool& threadPool, const std::atomic_bool& release)
+{
+    threadPool.add_task_detached([&release]()
+    {
+        const auto token = ext::this_thread::get_stop_token();
+        while (!release && !token.stop_requested())
+        {
+            ext::this_thread::yield();
+        }
+    });
+    while (threadPool.running_tasks_count() == 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+// graph with two root nodes and their common successor
+void add_nodes(ext::task_graph& graph, std::atomic_size_t& executedCount)
+{
+    const auto first = graph.add_node([&]() { ++executedCount; });
+    const auto second = graph.add_node([&]() { ++executedCount; });
+    graph.add_node([&]() { ++executedCount; }, { first, second });
+}
+
+} // namespace
+
+TEST(task_graph_test, dependencies_order)
+{
+    ext::thread_pool threadPool(4);
+    ext::task_graph graph(threadPool);
+
+    std::mutex orderMutex;
+    std::vector<char> order;
+    const auto addNode = [&](char name, std::initializer_list<ext::task_graph::NodeId> dependencies)
+    {
+        return graph.add_node([&, name]()
+        {
+            std::lock_guard lock(orderMutex);
+            order.push_back(name);
+        }, dependencies);
+    };
+
+    // diamond: a -> (b, c) -> d
+    const auto a = addNode('a', {});
+    const auto b = addNode('b', { a });
+    const auto c = addNode('c', { a });
+    const auto d = addNode('d', { b, c });
+    EXPECT_EQ(graph.nodes_count(), 4u);
+
+    const auto position = [&](char name) { return std::find(order.begin(), order.end(), name) - order.begin(); };
+    for (int run = 0; run < 10; ++run)
+    {
+        order.clear();
+        graph.run();
+        graph.wait();
+
+        ASSERT_EQ(order.size(), 4u);
+        EXPECT_EQ(order.front(), 'a');
+        EXPECT_EQ(order.back(), 'd');
+        EXPECT_LT(position('a'), position('b'));
+        EXPECT_LT(position('a'), position('c'));
+    }
+
+    EXPECT_TRUE(graph.get_node_timing(a).executed);
+    EXPECT_TRUE(graph.get_node_timing(d).executed);
+    EXPECT_GE(graph.get_node_timing(d).startOffset, graph.get_node_timing(a).startOffset);
+}
+
+TEST(task_graph_test, single_thread_long_chain)
+{
+    // workers never wait for dependencies, so even one thread executes the whole graph
+    ext::thread_pool threadPool(1);
+    ext::task_graph graph(threadPool);
+
+    std::atomic_uint executedCount = 0;
+    std::vector<ext::task_graph::NodeId> layer;
+    for (int i = 0; i < 10; ++i)
+    {
+        layer.push_back(graph.add_node([&]() { ++executedCount; }));
+    }
+    for (int level = 0; level < 10; ++level)
+    {
+        std::vector<ext::task_graph::NodeId> nextLayer;
+        for (int i = 0; i < 10; ++i)
+        {
+            const auto node = graph.add_node([&]() { ++executedCount; });
+            for (auto dependency : layer)
+            {
+                graph.add_dependency(node, dependency);
+            }
+            nextLayer.push_back(node);
+        }
+        layer = std::move(nextLayer);
+    }
+
+    graph.run();
+    graph.wait();
+    EXPECT_EQ(executedCount, 110u);
+}
+
+TEST(task_graph_test, node_exception)
+{
+    ext::thread_pool threadPool(2);
+    ext::task_graph graph(threadPool);
+
+    std::atomic_bool dependentExecuted = false;
+    const auto failed = graph.add_node([]() { throw std::runtime_error("Node error"); });
+    const auto dependent = graph.add_node([&]() { dependentExecuted = true; }, { failed });
+    graph.add_node([]() {});
+
+    graph.run();
+    EXPECT_THROW(graph.wait(), std::runtime_error);
+    EXPECT_FALSE(dependentExecuted);
+    EXPECT_TRUE(graph.get_node_timing(failed).executed);
+    EXPECT_FALSE(graph.get_node_timing(dependent).executed);
+
+    // error of the last run is reported till the next run
+    EXPECT_THROW(graph.wait(), std::runtime_error);
+}
+
+TEST(task_graph_test, node_exception_skips_successors)
+{
+    ext::thread_pool threadPool(2);
+    ext::task_graph graph(threadPool);
+
+    // several successors become ready at once and are finished in skip mode by the failed node thread
+    std::atomic_size_t executedCount = 0;
+    const auto failed = graph.add_node([]() { throw std::runtime_error("Node error"); });
+    for (int i = 0; i < 5; ++i)
+    {
+        const auto successor = graph.add_node([&]() { ++executedCount; }, { failed });
+        graph.add_node([&]() { ++executedCount; }, { successor });
+    }
+
+    // skipped nodes are finished in each run
+    for (int run = 0; run < 2; ++run)
+    {
+        graph.run();
+        EXPECT_THROW(graph.wait(), std::runtime_error);
+        EXPECT_FALSE(graph.running());
+        EXPECT_EQ(executedCount, 0u);
+    }
+}
+
+TEST(task_graph_test, pool_rejects_nodes)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .queueCapacity = 1,
+                                                           .overflowPolicy = ext::thread_pool::OverflowPolicy::eReject });
+    ext::task_graph graph(threadPool);
+
+    // root node takes the only queue place, its successors scheduling is rejected
+    std::atomic_size_t successorsExecuted = 0;
+    const auto root = graph.add_node([&]() { threadPool.add_task_detached([]() {}); });
+    for (int i = 0; i < 3; ++i)
+    {
+        graph.add_node([&]() { ++successorsExecuted; }, { root });
+    }
+
+    graph.run();
+    EXPECT_THROW(graph.wait(), ext::thread_pool::queue_overflow);
+    EXPECT_FALSE(graph.running());
+    EXPECT_EQ(successorsExecuted, 0u);
+    threadPool.wait_for_tasks();
+
+    // root nodes are rejected, run is not started
+    ext::Event release;
+    threadPool.add_task_detached([&]() { release.Wait(); });
+    while (threadPool.running_tasks_count() == 0)
+    {
+        std::this_thread::yield();
+    }
+    threadPool.add_task_detached([]() {});
+    EXPECT_THROW(graph.run(), ext::thread_pool::queue_overflow);
+    EXPECT_FALSE(graph.running());
+    graph.wait();
+
+    release.RaiseAll();
+    threadPool.wait_for_tasks();
+}
+
+TEST(task_graph_test, pool_drops_oldest_node)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .queueCapacity = 2,
+                                                           .overflowPolicy = ext::thread_pool::OverflowPolicy::eDropOldest });
+    ext::task_graph graph(threadPool);
+    std::atomic_size_t executedCount = 0;
+    add_nodes(graph, executedCount);
+
+    std::atomic_bool release = false;
+    block_worker(threadPool, release);
+    graph.run();
+    // the first root node is dropped, the run fails and the rest nodes are skipped
+    threadPool.add_task_detached([]() {});
+
+    release = true;
+    EXPECT_THROW(graph.wait(), std::future_error);
+    EXPECT_FALSE(graph.running());
+    EXPECT_EQ(executedCount, 0u);
+    threadPool.wait_for_tasks();
+}
+
+TEST(task_graph_test, pool_removes_node)
+{
+    ext::thread_pool threadPool(1);
+    ext::task_graph graph(threadPool);
+    std::atomic_size_t executedCount = 0;
+    graph.add_node([&]() { ++executedCount; });
+
+    std::atomic_bool release = false;
+    block_worker(threadPool, release);
+    // removed task object is reused by the next task with the next generation
+    auto nodeTaskId = threadPool.add_task([]() {}).first;
+    ASSERT_TRUE(threadPool.stop_and_remove_task(nodeTaskId));
+    ++nodeTaskId.generation;
+
+    graph.run();
+    ASSERT_TRUE(threadPool.stop_and_remove_task(nodeTaskId));
+    EXPECT_THROW(graph.wait(), std::future_error);
+    EXPECT_FALSE(graph.running());
+    EXPECT_EQ(executedCount, 0u);
+
+    release = true;
+    threadPool.wait_for_tasks();
+}
+
+TEST(task_graph_test, pool_removes_all_nodes)
+{
+    ext::thread_pool threadPool(1);
+    ext::task_graph graph(threadPool);
+    std::atomic_size_t executedCount = 0;
+    add_nodes(graph, executedCount);
+
+    std::atomic_bool release = false;
+    block_worker(threadPool, release);
+    graph.run();
+    threadPool.interrupt_and_remove_all_tasks();
+
+    EXPECT_THROW(graph.wait(), std::future_error);
+    EXPECT_FALSE(graph.running());
+    EXPECT_EQ(executedCount, 0u);
+}
+
+TEST(task_graph_test, pool_destruction_releases_nodes)
+{
+    std::atomic_size_t executedCount = 0;
+    auto threadPool = std::make_unique<ext::thread_pool>(1);
+    ext::task_graph graph(*threadPool);
+    add_nodes(graph, executedCount);
+
+    std::atomic_bool release = false;
+    block_worker(*threadPool, release);
+    graph.run();
+    threadPool.reset();
+
+    EXPECT_THROW(graph.wait(), std::future_error);
+    EXPECT_FALSE(graph.running());
+    EXPECT_EQ(executedCount, 0u);
+}
+
+TEST(task_graph_test, invalid_graph)
+{
+    ext::task_graph graph;
+    EXPECT_THROW(graph.add_node([]() {}, { 0 }), ext::check::CheckFailedException);
+
+    const auto a = graph.add_node([]() {});
+    const auto b = graph.add_node([]() {}, { a });
+    EXPECT_THROW(graph.add_dependency(a, a), ext::check::CheckFailedException);
+
+    graph.add_dependency(a, b);
+    EXPECT_THROW(graph.run(), ext::check::CheckFailedException);
+}
+
+TEST(task_graph_test, timing)
+{
+    ext::thread_pool threadPool(2);
+    ext::task_graph graph(threadPool);
+
+    const auto first = graph.add_node([]() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); });
+    const auto second = graph.add_node([]() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); }, { first });
+
+    graph.run();
+    graph.wait();
+    EXPECT_FALSE(graph.running());
+
+    const auto firstTiming = graph.get_node_timing(first);
+    const auto secondTiming = graph.get_node_timing(second);
+    EXPECT_GE(firstTiming.duration, std::chrono::milliseconds(20));
+    EXPECT_GE(secondTiming.startOffset, firstTiming.startOffset + firstTiming.duration);
+    EXPECT_GE(graph.get_run_duration(), std::chrono::milliseconds(40));
+}
@@ -0,0 +1,243 @@
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <ext/thread/event.h>
+#include <ext/thread/task_group.h>
+#include <ext/thread/thread_pool.h>
+
+TEST(task_group_test, wait_only_group_tasks)
+{
+    ext::thread_pool threadPool(2);
+    ext::task_group group(threadPool);
+
+    // task outside of the group doesn't block the group waiting
+    ext::Event continueExecution;
+    threadPool.add_task([&]() { continueExecution.Wait(); });
+
+    std::atomic_uint executedCount = 0;
+    for (unsigned i = 0; i < 100; ++i)
+    {
+        group.add_task([&](unsigned value) { executedCount += value; }, 1u);
+    }
+    group.wait();
+    EXPECT_EQ(executedCount, 100u);
+    EXPECT_EQ(group.tasks_count(), 0u);
+
+    continueExecution.RaiseAll();
+    threadPool.wait_for_tasks();
+}
+
+TEST(task_group_test, independent_groups)
+{
+    ext::thread_pool threadPool(2);
+    ext::task_group firstGroup(threadPool), secondGroup(threadPool);
+
+    ext::Event continueExecution;
+    firstGroup.add_task([&]() { continueExecution.Wait(); });
+
+    std::atomic_bool executed = false;
+    secondGroup.add_task([&]() { executed = true; });
+    secondGroup.wait();
+    EXPECT_TRUE(executed);
+    EXPECT_EQ(firstGroup.tasks_count(), 1u);
+
+    continueExecution.RaiseAll();
+    firstGroup.wait();
+}
+
+TEST(task_group_test, exception)
+{
+    ext::thread_pool threadPool(2);
+    ext::task_group group(threadPool);
+
+    std::atomic_uint executedCount = 0;
+    group.add_task([]() { throw std::runtime_error("Group task error"); });
+    for (int i = 0; i < 10; ++i)
+    {
+        group.add_task([&]() { ++executedCount; });
+    }
+    EXPECT_THROW(group.wait(), std::runtime_error);
+    EXPECT_EQ(executedCount, 10u);
+
+    // exception is reported once
+    EXPECT_NO_THROW(group.wait());
+}
+
+TEST(task_group_test, cancel)
+{
+    ext::thread_pool threadPool(1);
+    ext::task_group group(threadPool);
+
+    ext::Event taskStarted;
+    std::atomic_bool interrupted = false;
+    group.add_task([&]()
+    {
+        taskStarted.RaiseAll();
+        while (!ext::this_thread::interruption_requested())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        interrupted = true;
+    });
+    ASSERT_TRUE(taskStarted.Wait(std::chrono::seconds(1)));
+
+    std::atomic_uint executedCount = 0;
+    for (int i = 0; i < 10; ++i)
+    {
+        group.add_task([&]() { ++executedCount; });
+    }
+
+    group.cancel();
+    EXPECT_TRUE(interrupted);
+    EXPECT_TRUE(group.cancelling());
+    EXPECT_EQ(group.tasks_count(), 0u);
+
+    // tasks added during cancelling are not executed
+    group.add_task([&]() { ++executedCount; });
+    group.wait();
+    EXPECT_EQ(executedCount, 0u);
+    EXPECT_FALSE(group.cancelling());
+
+    group.add_task([&]() { ++executedCount; });
+    group.wait();
+    EXPECT_EQ(executedCount, 1u);
+}
+
+TEST(task_group_test, cancel_from_group_task)
+{
+    ext::thread_pool threadPool(1);
+    ext::task_group group(threadPool);
+
+    std::atomic_uint executedCount = 0;
+    group.add_task([&]()
+    {
+        group.cancel();
+        ++executedCount;
+    });
+    for (int i = 0; i < 10; ++i)
+    {
+        group.add_task([&]() { ++executedCount; });
+    }
+    group.wait();
+    EXPECT_EQ(executedCount, 1u);
+
+    // running tasks cancel each other, they don't wait for each other
+    ext::thread_pool twoThreadsPool(2);
+    ext::task_group concurrentGroup(twoThreadsPool);
+    std::atomic_uint startedCount = 0;
+    executedCount = 0;
+    for (int i = 0; i < 2; ++i)
+    {
+        concurrentGroup.add_task([&]()
+        {
+            ++startedCount;
+            while (startedCount != 2)
+            {
+                std::this_thread::yield();
+            }
+            concurrentGroup.cancel();
+            ++executedCount;
+        });
+    }
+    concurrentGroup.wait();
+    EXPECT_EQ(executedCount, 2u);
+}
+
+TEST(task_group_test, move_only_arguments)
+{
+    ext::task_group group;
+
+    std::atomic_int result = 0;
+    group.add_task([&](std::unique_ptr<int> value) { result = *value; }, std::make_unique<int>(10));
+    group.wait();
+    EXPECT_EQ(result, 10);
+}
+
+TEST(task_group_test, captures_destroyed_before_wait_end)
+{
+    // slow destruction of the task captured object, group waiters must wait for it
+    struct slow_destruction
+    {
+        explicit slow_destruction(std::atomic_uint& destroyedCount) noexcept : destroyedCount(&destroyedCount) {}
+        slow_destruction(slow_destruction&& other) noexcept : destroyedCount(std::exchange(other.destroyedCount, nullptr)) {}
+        ~slow_destruction()
+        {
+            if (!destroyedCount)
+                return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            ++*destroyedCount;
+        }
+
+        std::atomic_uint* destroyedCount;
+    };
+
+    ext::thread_pool threadPool(2);
+    std::atomic_uint destroyedCount = 0;
+    {
+        ext::task_group group(threadPool);
+        group.add_task([captured = slow_destruction(destroyedCount)]() {});
+        group.add_task([](const slow_destruction&) {}, slow_destruction(destroyedCount));
+        group.wait();
+        EXPECT_EQ(destroyedCount, 2u);
+    }
+    threadPool.wait_for_tasks();
+}
+
+TEST(task_group_test, bounded_pool_overflow_policies)
+{
+    using Policy = ext::thread_pool::OverflowPolicy;
+    for (const auto policy : { Policy::eBlock, Policy::eReject, Policy::eCallerRuns, Policy::eDropOldest })
+    {
+        SCOPED_TRACE(static_cast<int>(policy));
+
+        ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .queueCapacity = 2,
+                                                               .overflowPolicy = policy });
+        ext::task_group group(threadPool);
+
+        std::atomic_uint addedCount = 0;
+        std::atomic_uint executedCount = 0;
+        const auto add = [&](auto&& function)
+        {
+            try
+            {
+                group.add_task(std::forward<decltype(function)>(function));
+                ++addedCount;
+            }
+            catch (const ext::thread_pool::queue_overflow&)
+            {
+                EXPECT_EQ(policy, Policy::eReject);
+            }
+        };
+
+        // group task adds tasks to the full queue from the worker thread
+        add([&]()
+        {
+            for (int i = 0; i < 10; ++i)
+            {
+                add([&]() { ++executedCount; });
+            }
+            ++executedCount;
+        });
+        for (int i = 0; i < 20; ++i)
+        {
+            add([&]() { ++executedCount; });
+        }
+
+        group.wait();
+        EXPECT_EQ(group.tasks_count(), 0u);
+        if (policy == Policy::eDropOldest)
+        {
+            EXPECT_LE(executedCount, addedCount);
+        }
+        else
+        {
+            EXPECT_EQ(executedCount, addedCount);
+        }
+    }
+}
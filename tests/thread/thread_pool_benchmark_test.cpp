@@ -0,0 +1,138 @@
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include <ext/thread/thread_pool.h>
+
+// Benchmarks are disabled by default, run them with --gtest_also_run_disabled_tests --gtest_filter=*benchmark*
+
+namespace {
+
+// small task with some calculations to emulate a real work
+void small_task(std::atomic_uint64_t& result)
+{
+    std::uint64_t value = 0;
+    for (std::uint64_t i = 0; i < 200; ++i)
+    {
+        value += i * i;
+    }
+    result += value;
+}
+
+// executes kRootTasks tasks which add kSubTasks from the worker threads, returns execution time
+std::chrono::microseconds run_nested_tasks(ext::thread_pool& threadPool)
+{
+    constexpr unsigned kRootTasks = 100;
+    constexpr unsigned kSubTasks = 1000;
+
+    std::atomic_uint64_t result = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < kRootTasks; ++i)
+    {
+        threadPool.add_task([&]()
+        {
+            for (unsigned j = 0; j < kSubTasks; ++j)
+            {
+                threadPool.add_task(small_task, std::ref(result));
+            }
+        });
+    }
+    threadPool.wait_for_tasks();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+}
+
+} // namespace
+
+TEST(thread_pool_benchmark, DISABLED_work_stealing_scaling)
+{
+    std::cout << std::setw(10) << "threads" << std::setw(16) << "shared(us)" << std::setw(16) << "stealing(us)" << std::endl;
+
+    for (std::uint_fast32_t threads = 1; threads <= ext::available_concurrency(); ++threads)
+    {
+        ext::thread_pool sharedQueuePool(ext::thread_pool::Options{ .threadsCount = threads });
+        ext::thread_pool workStealingPool(ext::thread_pool::Options{ .threadsCount = threads, .workStealing = true });
+
+        std::cout << std::setw(10) << threads
+                  << std::setw(16) << run_nested_tasks(sharedQueuePool).count()
+                  << std::setw(16) << run_nested_tasks(workStealingPool).count() << std::endl;
+    }
+}
+
+TEST(thread_pool_benchmark, DISABLED_tasks_submission)
+{
+    constexpr unsigned kTasksCount = 1000000;
+
+    ext::thread_pool threadPool;
+    std::atomic_uint64_t result = 0;
+
+    const auto measure = [&](auto&& addTask)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < kTasksCount; ++i)
+        {
+            addTask();
+        }
+        threadPool.wait_for_tasks();
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::cout << "add_task(us): " << measure([&]() { EXT_IGNORE_RESULT(threadPool.add_task(small_task, std::ref(result))); }) << std::endl;
+    std::cout << "add_task_detached(us): " << measure([&]() { threadPool.add_task_detached(small_task, std::ref(result)); }) << std::endl;
+
+    const std::vector<unsigned> batchElements(kTasksCount);
+    const auto batchStart = std::chrono::steady_clock::now();
+    threadPool.add_tasks(batchElements, [&result](unsigned) { small_task(result); }).wait();
+    std::cout << "add_tasks(us): " << std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - batchStart).count() << std::endl;
+}
+
+TEST(thread_pool_benchmark, DISABLED_metrics_overhead)
+{
+    std::cout << std::setw(10) << "threads" << std::setw(16) << "disabled(us)" << std::setw(16) << "enabled(us)" << std::endl;
+
+    for (std::uint_fast32_t threads = 1; threads <= ext::available_concurrency(); threads *= 2)
+    {
+        ext::thread_pool disabledPool(ext::thread_pool::Options{ .threadsCount = threads });
+        ext::thread_pool enabledPool(ext::thread_pool::Options{ .threadsCount = threads, .collectMetrics = true });
+
+        std::cout << std::setw(10) << threads
+                  << std::setw(16) << run_nested_tasks(disabledPool).count()
+                  << std::setw(16) << run_nested_tasks(enabledPool).count() << std::endl;
+    }
+}
+
+TEST(thread_pool_benchmark, DISABLED_idle_spin_latency)
+{
+    constexpr unsigned kTasksCount = 10000;
+
+    std::cout << std::setw(12) << "spin steps" << std::setw(16) << "latency(ns)" << std::setw(16) << "cpu time(us)" << std::endl;
+
+    for (std::uint_fast32_t spinSteps : { 0u, 4u, 8u, 10u })
+    {
+        ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 4, .idleSpinSteps = spinSteps });
+
+        // steady trickle of tasks: each task is submitted after the previous one is done and after a short pause,
+        // so workers become idle between tasks
+        std::chrono::nanoseconds latency(0);
+        const std::clock_t cpuStart = std::clock();
+        for (unsigned i = 0; i < kTasksCount; ++i)
+        {
+            const auto submitTime = std::chrono::steady_clock::now();
+            const auto startTime = threadPool.add_task([]() { return std::chrono::steady_clock::now(); }).second.get();
+            latency += startTime - submitTime;
+
+            const auto pauseEnd = std::chrono::steady_clock::now() + std::chrono::microseconds(20);
+            while (std::chrono::steady_clock::now() < pauseEnd)
+            {}
+        }
+        const std::clock_t cpuTime = std::clock() - cpuStart;
+
+        std::cout << std::setw(12) << spinSteps
+                  << std::setw(16) << latency.count() / kTasksCount
+                  << std::setw(16) << cpuTime * 1000000 / CLOCKS_PER_SEC << std::endl;
+    }
+}
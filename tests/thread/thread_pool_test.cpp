@@ -1,8 +1,53 @@
 #include "gtest/gtest.h"
 
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <numeric>
+#include <set>
+#include <string>
+#include <unordered_set>
+
+#include "allocations_helper.h"
+#include "cpu_helper.h"
+
 #include <ext/thread/event.h>
 #include <ext/thread/thread_pool.h>
 
+namespace {
+
+// wait till condition becomes true or timeout expires
+template <typename Condition>
+bool wait_for_condition(Condition&& condition, std::chrono::steady_clock::duration timeout = std::chrono::seconds(5))
+{
+    const auto end = std::chrono::steady_clock::now() + timeout;
+    while (!condition())
+    {
+        if (std::chrono::steady_clock::now() > end)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// start the only worker of the pool and block it till the returned event is raised
+std::shared_ptr<ext::Event> block_worker(ext::thread_pool& threadPool, ext::thread_pool::TaskId* blockingTaskId = nullptr)
+{
+    auto taskStarted = std::make_shared<ext::Event>();
+    auto continueExecution = std::make_shared<ext::Event>();
+    const auto taskId = threadPool.add_task_detached([taskStarted, continueExecution]()
+    {
+        taskStarted->RaiseAll();
+        continueExecution->Wait();
+    });
+    if (blockingTaskId)
+        *blockingTaskId = taskId;
+    EXPECT_TRUE(taskStarted->Wait(std::chrono::seconds(1)));
+    return continueExecution;
+}
+
+} // namespace
+
 TEST(thread_pool_test, add_task)
 {
     std::atomic_uint onDoneCalls = 0;
@@ -345,4 +390,1100 @@ TEST(thread_pool_test, task_interruption)
 
     threadPool.wait_for_tasks();
     EXPECT_TRUE(firstTaskWasInterrupted) << "Task should be interrupted";
-}
\ No newline at end of file
+}
+
+TEST(thread_pool_test, work_stealing_nested_tasks)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 4, .workStealing = true });
+
+    constexpr unsigned kTasksCount = 100;
+    std::atomic_uint executedTasksCount = 0;
+    for (unsigned i = 0; i < kTasksCount; ++i)
+    {
+        threadPool.add_task([&]()
+        {
+            for (unsigned j = 0; j < kTasksCount; ++j)
+            {
+                threadPool.add_task([&]() { ++executedTasksCount; });
+            }
+        });
+    }
+
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(executedTasksCount, kTasksCount * kTasksCount);
+    EXPECT_EQ(threadPool.running_tasks_count(), 0u);
+}
+
+TEST(thread_pool_test, work_stealing_idle_worker_steals_task)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2, .workStealing = true });
+
+    ext::Event subTaskExecuted;
+    std::thread::id parentThreadId, subTaskThreadId;
+    threadPool.add_task([&]()
+    {
+        parentThreadId = std::this_thread::get_id();
+        // task is added to the current worker queue, only another worker can execute it while we are waiting
+        threadPool.add_task([&]()
+        {
+            subTaskThreadId = std::this_thread::get_id();
+            subTaskExecuted.RaiseAll();
+        });
+        EXPECT_TRUE(subTaskExecuted.Wait(std::chrono::seconds(5)));
+    });
+
+    threadPool.wait_for_tasks();
+    EXPECT_TRUE(subTaskExecuted.Raised());
+    EXPECT_NE(parentThreadId, subTaskThreadId);
+}
+
+TEST(thread_pool_test, work_stealing_remove_local_task)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .workStealing = true });
+
+    std::atomic_bool removedTaskExecuted = false;
+    threadPool.add_task([&]()
+    {
+        const auto taskId = threadPool.add_task([&]() { removedTaskExecuted = true; }).first;
+        EXPECT_TRUE(threadPool.stop_and_remove_task(taskId));
+    });
+
+    threadPool.wait_for_tasks();
+    EXPECT_FALSE(removedTaskExecuted);
+}
+
+TEST(thread_pool_test, add_task_detached)
+{
+    ext::thread_pool threadPool(2);
+
+    std::atomic_uint executedTasksCount = 0;
+    threadPool.add_task_detached([&]() { ++executedTasksCount; });
+    // move only arguments
+    threadPool.add_task_detached([&](std::unique_ptr<unsigned> value) { executedTasksCount += *value; },
+                                 std::make_unique<unsigned>(2));
+    // function which doesn't fit into the task buffer
+    std::array<unsigned, 100> values{};
+    values.back() = 3;
+    threadPool.add_task_detached([&executedTasksCount, values]() { executedTasksCount += values.back(); });
+    // exceptions are not passed to the caller
+    threadPool.add_task_detached([]() { throw std::runtime_error("Task error"); });
+
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(executedTasksCount, 6u);
+}
+
+TEST(thread_pool_test, add_task_detached_without_allocations)
+{
+    ext::thread_pool threadPool(2);
+
+    // warm up: more tasks are queued at once than workers cache released tasks objects,
+    // so the released objects are always available for the next tasks
+    ext::Event continueExecution;
+    for (int i = 0; i < 2; ++i)
+    {
+        threadPool.add_task_detached([&]() { continueExecution.Wait(); });
+    }
+    std::atomic_uint executedTasksCount = 0;
+    for (int i = 0; i < 1000; ++i)
+    {
+        threadPool.add_task_detached([&executedTasksCount]() { ++executedTasksCount; });
+    }
+    continueExecution.RaiseAll();
+    threadPool.wait_for_tasks();
+
+    // small function is kept in the task buffer, tasks objects are reused
+    const std::size_t allocationsCount = test::allocations::allocations_count;
+    for (int round = 0; round < 10; ++round)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            threadPool.add_task_detached([&executedTasksCount]() { ++executedTasksCount; });
+        }
+        threadPool.wait_for_tasks();
+    }
+    EXPECT_EQ(test::allocations::allocations_count, allocationsCount);
+    EXPECT_EQ(executedTasksCount, 2000u);
+}
+
+TEST(thread_pool_test, task_id_handles)
+{
+    ext::thread_pool threadPool(1);
+
+    ext::thread_pool::TaskId blockingTaskId;
+    const auto continueExecution = block_worker(threadPool, &blockingTaskId);
+
+    std::atomic_uint executedTasksCount = 0;
+    std::vector<ext::thread_pool::TaskId> taskIds;
+    for (int i = 0; i < 100; ++i)
+    {
+        taskIds.emplace_back(threadPool.add_task_detached([&]() { ++executedTasksCount; }));
+    }
+    std::unordered_set<ext::thread_pool::TaskId> uniqueIds(taskIds.begin(), taskIds.end());
+    EXPECT_EQ(uniqueIds.size(), taskIds.size());
+    EXPECT_EQ(uniqueIds.count(blockingTaskId), 0u);
+
+    for (std::size_t i = 0; i < taskIds.size(); i += 2)
+    {
+        EXPECT_TRUE(threadPool.stop_and_remove_task(taskIds[i]));
+        EXPECT_FALSE(threadPool.stop_and_remove_task(taskIds[i]));
+    }
+
+    continueExecution->RaiseAll();
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(executedTasksCount, 50u);
+
+    // identifiers of the finished tasks stay invalid after reusing of the pool objects
+    for (int i = 0; i < 100; ++i)
+    {
+        uniqueIds.emplace(threadPool.add_task_detached([]() {}));
+    }
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(uniqueIds.size(), 200u);
+    for (const auto& taskId : taskIds)
+    {
+        EXPECT_FALSE(threadPool.stop_and_remove_task(taskId));
+    }
+    EXPECT_FALSE(threadPool.stop_and_remove_task(blockingTaskId));
+    EXPECT_FALSE(threadPool.stop_and_remove_task(ext::thread_pool::TaskId()));
+}
+
+TEST(thread_pool_test, add_tasks_batch)
+{
+    ext::thread_pool threadPool(4);
+
+    std::vector<unsigned> values(1000);
+    std::iota(values.begin(), values.end(), 1);
+
+    std::atomic_uint sum = 0;
+    auto batch = threadPool.add_tasks(values, [&sum](unsigned value) { sum += value; });
+    EXPECT_EQ(batch.size(), values.size());
+    batch.wait();
+    EXPECT_EQ(sum, 1000u * 1001u / 2);
+
+    // elements of the rvalue range are moved to the tasks
+    std::vector<std::unique_ptr<unsigned>> pointers;
+    for (unsigned i = 0; i < 10; ++i)
+    {
+        pointers.emplace_back(std::make_unique<unsigned>(i));
+    }
+    std::atomic_uint pointersSum = 0;
+    threadPool.add_tasks(std::move(pointers), [&pointersSum](std::unique_ptr<unsigned> pointer)
+    {
+        pointersSum += *pointer;
+    }).wait();
+    EXPECT_EQ(pointersSum, 45u);
+
+    threadPool.add_tasks(std::vector<int>(), [](int) {}).wait();
+
+    // indexes range doesn't need a container of the arguments
+    std::atomic_size_t indexesSum = 0;
+    auto indexesBatch = threadPool.add_tasks(ext::thread_pool::IndexRange(100),
+                                             [&indexesSum](std::size_t index) { indexesSum += index; });
+    EXPECT_EQ(indexesBatch.size(), 100u);
+    indexesBatch.wait();
+    EXPECT_EQ(indexesSum, 99u * 100u / 2);
+
+    auto futures = threadPool.add_task_batch(values, [](unsigned value) { return value * 2; });
+    ASSERT_EQ(futures.size(), values.size());
+    for (std::size_t i = 0; i < futures.size(); ++i)
+    {
+        EXPECT_EQ(futures[i].get(), values[i] * 2);
+    }
+}
+
+TEST(thread_pool_test, add_tasks_batch_removed)
+{
+    ext::thread_pool threadPool(1);
+
+    ext::Event taskStarted;
+    std::atomic_bool blockingTaskInterrupted = false;
+    threadPool.add_task_detached([&]()
+    {
+        taskStarted.RaiseAll();
+        try
+        {
+            ext::this_thread::interruptible_sleep_for(std::chrono::seconds(5));
+        }
+        catch (const ext::thread::thread_interrupted&)
+        {
+            blockingTaskInterrupted = true;
+        }
+    });
+    ASSERT_TRUE(taskStarted.Wait(std::chrono::seconds(1)));
+
+    std::atomic_uint executedTasksCount = 0;
+    auto batch = threadPool.add_tasks(std::vector<int>(100), [&](int) { ++executedTasksCount; });
+
+    // worker is still blocked, all batch tasks are removed before execution
+    threadPool.interrupt_and_remove_all_tasks();
+    // removed tasks are considered as done
+    batch.wait();
+    EXPECT_TRUE(blockingTaskInterrupted);
+    EXPECT_EQ(executedTasksCount, 0u);
+}
+
+TEST(thread_pool_test, priority_levels)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .priorityLevelsCount = 4 });
+
+    const auto continueExecution = block_worker(threadPool);
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    const auto addTask = [&](ext::thread_pool::Priority priority, int value)
+    {
+        return threadPool.add_task_with_priority(priority, [&, value]()
+        {
+            std::lock_guard lock(orderMutex);
+            order.push_back(value);
+        }).first;
+    };
+
+    addTask(0, 0);
+    addTask(2, 20);
+    addTask(1, 10);
+    const auto removedTaskId = addTask(3, 30);
+    addTask(2, 21);
+    addTask(0, 1);
+    EXPECT_TRUE(threadPool.stop_and_remove_task(removedTaskId));
+    threadPool.add_high_priority_task([&]()
+    {
+        std::lock_guard lock(orderMutex);
+        order.push_back(31);
+    });
+    EXPECT_THROW(addTask(4, 40), ext::check::CheckFailedException);
+
+    continueExecution->RaiseAll();
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(order, std::vector<int>({ 31, 20, 21, 10, 0, 1 }));
+}
+
+TEST(thread_pool_test, priority_aging)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .agingTime = std::chrono::milliseconds(50) });
+
+    const auto continueExecution = block_worker(threadPool);
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    threadPool.add_task([&]()
+    {
+        std::lock_guard lock(orderMutex);
+        order.push_back(0);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    for (int i = 1; i <= 3; ++i)
+    {
+        threadPool.add_high_priority_task([&, i]()
+        {
+            std::lock_guard lock(orderMutex);
+            order.push_back(i);
+        });
+    }
+
+    continueExecution->RaiseAll();
+    threadPool.wait_for_tasks();
+    // normal priority task waited longer than aging time and is executed first
+    EXPECT_EQ(order, std::vector<int>({ 0, 1, 2, 3 }));
+}
+
+TEST(thread_pool_test, priority_aging_with_deadlines_and_fair_queues)
+{
+    for (const bool fairQueueTask : { false, true })
+    {
+        SCOPED_TRACE(fairQueueTask);
+
+        // new pool for each case, fair share round starts with the fair queues
+        ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1,
+                                                               .agingTime = std::chrono::milliseconds(50),
+                                                               .earliestDeadlineFirst = true });
+        const auto fairQueue = threadPool.add_queue("fair");
+        const auto continueExecution = block_worker(threadPool);
+
+        std::mutex orderMutex;
+        std::vector<int> order;
+        const auto addToOrder = [&](int value)
+        {
+            std::lock_guard lock(orderMutex);
+            order.push_back(value);
+        };
+
+        // the old task is behind the newer deadline task in the normal level
+        if (fairQueueTask)
+            threadPool.add_task_to_queue(fairQueue, addToOrder, 0);
+        else
+            threadPool.add_task(addToOrder, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        threadPool.add_high_priority_task(addToOrder, 2);
+        threadPool.add_task_with_deadline(std::chrono::steady_clock::now() + std::chrono::hours(1), addToOrder, 1);
+
+        continueExecution->RaiseAll();
+        threadPool.wait_for_tasks();
+        if (fairQueueTask)
+        {
+            // normal level has the aged task and is executed first, the fair queue has the turn and gives the aged task,
+            // then the level isn't aged anymore and the high priority task goes before the deadline task
+            EXPECT_EQ(order, std::vector<int>({ 0, 2, 1 }));
+        }
+        else
+        {
+            // normal level has the aged task and is executed first, deadline task is the first in the level
+            // and the aged task keeps the level selected
+            EXPECT_EQ(order, std::vector<int>({ 1, 0, 2 }));
+        }
+    }
+}
+
+TEST(thread_pool_test, elastic_spawn_and_retire)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{
+        .threadsCount = 1, .maxThreadsCount = 4,
+        .spawnThreadLatency = std::chrono::milliseconds(5), .idleThreadTimeout = std::chrono::milliseconds(100) });
+    EXPECT_EQ(threadPool.threads_count(), 1u);
+
+    // blocking tasks, each of them holds one thread
+    ext::Event continueExecution;
+    std::atomic_uint startedTasks = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        threadPool.add_task_detached([&]()
+        {
+            ++startedTasks;
+            continueExecution.Wait();
+        });
+    }
+
+    EXPECT_TRUE(wait_for_condition([&]() { return startedTasks == 4; }));
+    EXPECT_EQ(threadPool.threads_count(), 4u);
+    EXPECT_TRUE(wait_for_condition([&]() { return threadPool.get_threads_counters().maxThreadsReachedCount != 0; }));
+
+    continueExecution.RaiseAll();
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(startedTasks, 5u);
+
+    // extra threads are stopped after idle timeout
+    EXPECT_TRUE(wait_for_condition([&]() { return threadPool.threads_count() == 1; }));
+    const auto counters = threadPool.get_threads_counters();
+    EXPECT_EQ(counters.threadsCount, 1u);
+    EXPECT_EQ(counters.peakThreadsCount, 4u);
+    EXPECT_EQ(counters.spawnedThreadsCount, 3u);
+    EXPECT_EQ(counters.retiredThreadsCount, 3u);
+}
+
+TEST(thread_pool_test, elastic_without_threads)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{
+        .threadsCount = 0, .maxThreadsCount = 2, .idleThreadTimeout = std::chrono::milliseconds(20) });
+    EXPECT_EQ(threadPool.threads_count(), 0u);
+
+    // threads are started on demand and the retired threads slots are reused
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(threadPool.add_task([i]() { return i; }).second.get(), i);
+        EXPECT_TRUE(wait_for_condition([&]() { return threadPool.threads_count() == 0; }));
+    }
+    EXPECT_EQ(threadPool.get_threads_counters().retiredThreadsCount, 3u);
+
+    EXPECT_THROW(ext::thread_pool(ext::thread_pool::Options{ .threadsCount = 2, .maxThreadsCount = 1 }),
+                 ext::check::CheckFailedException);
+}
+
+TEST(thread_pool_test, pinned_workers)
+{
+    const unsigned allowedCpu = test::cpu::get_allowed_cpu();
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2, .threadsName = "ext_pool", .workersCpus = { allowedCpu } });
+
+    std::mutex namesMutex;
+    std::set<std::string> names;
+    std::atomic_uint executedOnOtherCpu = 0;
+    for (int i = 0; i < 20; ++i)
+    {
+        threadPool.add_task_detached([&]()
+        {
+#ifdef __linux__
+            if (sched_getcpu() != int(allowedCpu))
+                ++executedOnOtherCpu;
+
+            char name[16] = {};
+            pthread_getname_np(pthread_self(), name, sizeof(name));
+            std::lock_guard lock(namesMutex);
+            names.emplace(name);
+#endif
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        });
+    }
+    threadPool.wait_for_tasks();
+
+    EXPECT_EQ(executedOnOtherCpu, 0u);
+#ifdef __linux__
+    for (const auto& name : names)
+    {
+        EXPECT_TRUE(name == "ext_pool0" || name == "ext_pool1") << name;
+    }
+#endif
+
+    EXPECT_THROW(ext::thread_pool(ext::thread_pool::Options{ .workersCpus = { allowedCpu }, .numaAware = true }),
+                 ext::check::CheckFailedException);
+}
+
+TEST(thread_pool_test, numa_node_queues)
+{
+    // the second node has no workers, tasks of the first node worker are queued in the node queue
+    const unsigned allowedCpu = test::cpu::get_allowed_cpu();
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .numaAware = true,
+                                                           .numaNodesCpus = { { allowedCpu }, { allowedCpu } } });
+
+    ext::Event continueExecution;
+    std::atomic_uint executedCount = 0;
+    std::promise<ext::thread_pool::TaskId> removedTaskId;
+    threadPool.add_task([&]()
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            threadPool.add_task_detached([&]() { ++executedCount; });
+        }
+        removedTaskId.set_value(threadPool.add_task_detached([&]() { executedCount += 1000; }));
+        continueExecution.Wait();
+    });
+
+    EXPECT_TRUE(threadPool.stop_and_remove_task(removedTaskId.get_future().get()));
+    continueExecution.RaiseAll();
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(executedCount, 100u);
+}
+
+TEST(thread_pool_test, numa_node_tasks_stealing)
+{
+    // each worker belongs to own node, busy node tasks are executed by the worker of the other node
+    const unsigned allowedCpu = test::cpu::get_allowed_cpu();
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2, .numaAware = true,
+                                                           .numaNodesCpus = { { allowedCpu }, { allowedCpu } } });
+
+    std::atomic_uint executedCount = 0;
+    auto result = threadPool.add_task([&]()
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            threadPool.add_task_detached([&]() { ++executedCount; });
+        }
+
+        const auto end = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (executedCount != 100 && std::chrono::steady_clock::now() < end)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return executedCount.load();
+    });
+    EXPECT_EQ(result.second.get(), 100u);
+    threadPool.wait_for_tasks();
+}
+
+TEST(thread_pool_test, metrics)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2, .workStealing = true, .collectMetrics = true });
+
+    ext::Event continueExecution;
+    threadPool.add_task([&]() { continueExecution.Wait(); });
+    threadPool.add_task([&]() { continueExecution.Wait(); });
+    for (int i = 0; i < 10; ++i)
+    {
+        threadPool.add_task([]() { std::this_thread::sleep_for(std::chrono::milliseconds(2)); });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    continueExecution.RaiseAll();
+    threadPool.wait_for_tasks();
+
+    // idle time is counted when the sleeping worker wakes up
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    // tasks added from the worker thread are counted by the worker
+    threadPool.add_task([&]()
+    {
+        for (int i = 0; i < 5; ++i)
+        {
+            threadPool.add_task_detached([]() {});
+        }
+    });
+    threadPool.wait_for_tasks();
+
+    const auto metrics = threadPool.get_metrics();
+    ASSERT_EQ(metrics.workers.size(), 2u);
+    EXPECT_EQ(metrics.total.submittedTasksCount, 18u);
+    EXPECT_EQ(metrics.total.completedTasksCount, 18u);
+    EXPECT_EQ(metrics.total.queueWaitTime.count(), 18u);
+    EXPECT_EQ(metrics.total.executionTime.count(), 18u);
+    EXPECT_GE(metrics.queueDepthHighWaterMark, 10u);
+    EXPECT_EQ(metrics.queuedTasksCount, 0u);
+    EXPECT_GE(metrics.total.idleTime, std::chrono::milliseconds(5));
+
+    std::uint64_t workersSubmittedTasks = 0, workersCompletedTasks = 0;
+    for (const auto& worker : metrics.workers)
+    {
+        workersSubmittedTasks += worker.submittedTasksCount;
+        workersCompletedTasks += worker.completedTasksCount;
+    }
+    EXPECT_EQ(workersSubmittedTasks, 5u);
+    EXPECT_EQ(workersCompletedTasks, 18u);
+
+    // queued tasks waited for the blocking tasks at least 10ms, blocking tasks were executed at least 10ms
+    EXPECT_GE(metrics.total.queueWaitTime.percentile(0.9), std::chrono::milliseconds(8));
+    EXPECT_GE(metrics.total.executionTime.percentile(1.), std::chrono::milliseconds(8));
+    EXPECT_LE(metrics.total.executionTime.percentile(0.), metrics.total.executionTime.percentile(1.));
+}
+
+TEST(thread_pool_test, metrics_stolen_tasks)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2, .workStealing = true, .collectMetrics = true });
+
+    ext::Event subTaskExecuted;
+    threadPool.add_task([&]()
+    {
+        // task is added to the current worker queue, only another worker can execute it while we are waiting
+        threadPool.add_task([&]() { subTaskExecuted.RaiseAll(); });
+        EXPECT_TRUE(subTaskExecuted.Wait(std::chrono::seconds(5)));
+    });
+    threadPool.wait_for_tasks();
+
+    const auto metrics = threadPool.get_metrics();
+    EXPECT_GE(metrics.total.stolenTasksCount, 1u);
+    std::uint64_t workersStolenTasks = 0;
+    for (const auto& worker : metrics.workers)
+    {
+        workersStolenTasks += worker.stolenTasksCount;
+    }
+    EXPECT_EQ(workersStolenTasks, metrics.total.stolenTasksCount);
+}
+
+TEST(thread_pool_test, metrics_disabled)
+{
+    ext::thread_pool threadPool(2);
+    for (int i = 0; i < 10; ++i)
+    {
+        threadPool.add_task_detached([]() {});
+    }
+    threadPool.wait_for_tasks();
+
+    const auto metrics = threadPool.get_metrics();
+    EXPECT_EQ(metrics.total.submittedTasksCount, 0u);
+    EXPECT_EQ(metrics.total.completedTasksCount, 0u);
+    EXPECT_EQ(metrics.total.executionTime.count(), 0u);
+    EXPECT_EQ(metrics.queueDepthHighWaterMark, 0u);
+
+    ext::thread_pool::DurationHistogram histogram;
+    histogram.buckets[ext::thread_pool::DurationHistogram::get_bucket(std::chrono::microseconds(0))] += 1;
+    histogram.buckets[ext::thread_pool::DurationHistogram::get_bucket(std::chrono::microseconds(3))] += 1;
+    histogram.buckets[ext::thread_pool::DurationHistogram::get_bucket(std::chrono::hours(1000))] += 1;
+    EXPECT_EQ(histogram.count(), 3u);
+    EXPECT_EQ(histogram.percentile(0.), std::chrono::microseconds(1));
+    EXPECT_EQ(histogram.percentile(0.5), std::chrono::microseconds(4));
+    EXPECT_EQ(histogram.percentile(1.), ext::thread_pool::DurationHistogram::bucket_upper_bound(
+        ext::thread_pool::DurationHistogram::kBucketsCount - 1));
+}
+
+TEST(thread_pool_test, idle_spin_steps)
+{
+    // steps after the 8th sleep, check that sleeping spinners also take tasks
+    for (std::uint_fast32_t spinSteps : { 8u, 10u })
+    {
+        ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2, .idleSpinSteps = spinSteps });
+
+        // trickle of tasks, workers are spinning or sleeping between them
+        for (int i = 0; i < 100; ++i)
+        {
+            EXPECT_EQ(threadPool.add_task([i]() { return i; }).second.get(), i);
+        }
+
+        // bursts claim spinning workers and wake sleeping ones
+        std::atomic_int executedTasksCount = 0;
+        for (int i = 0; i < 10; ++i)
+        {
+            for (int j = 0; j < 10; ++j)
+            {
+                threadPool.add_task_detached([&]() { ++executedTasksCount; });
+            }
+            const std::vector<int> batch(10);
+            threadPool.add_tasks(batch, [&](int) { ++executedTasksCount; }).wait();
+        }
+        threadPool.wait_for_tasks();
+        EXPECT_EQ(executedTasksCount, 200);
+    }
+}
+
+TEST(thread_pool_test, task_deadline)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .collectMetrics = true });
+
+    const auto continueExecution = block_worker(threadPool);
+
+    std::atomic_bool expiredTaskExecuted = false;
+    auto expiredTask = threadPool.add_task_with_deadline(
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(10), [&]() { expiredTaskExecuted = true; });
+    auto task = threadPool.add_task_with_deadline(
+        std::chrono::steady_clock::now() + std::chrono::hours(1), [](int value) { return value; }, 10);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    continueExecution->RaiseAll();
+
+    EXPECT_THROW(expiredTask.second.get(), ext::thread_pool::deadline_exceeded);
+    EXPECT_FALSE(expiredTaskExecuted);
+    EXPECT_EQ(task.second.get(), 10);
+
+    threadPool.wait_for_tasks();
+    const auto metrics = threadPool.get_metrics();
+    EXPECT_EQ(metrics.total.expiredTasksCount, 1u);
+    EXPECT_EQ(metrics.total.completedTasksCount, 2u);
+}
+
+TEST(thread_pool_test, earliest_deadline_first)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .earliestDeadlineFirst = true });
+
+    const auto continueExecution = block_worker(threadPool);
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    const auto addTask = [&](int value, std::chrono::steady_clock::time_point deadline)
+    {
+        const auto task = [&, value]()
+        {
+            std::lock_guard lock(orderMutex);
+            order.push_back(value);
+        };
+        if (deadline == std::chrono::steady_clock::time_point::max())
+            threadPool.add_task_detached(task);
+        else
+            EXT_IGNORE_RESULT(threadPool.add_task_with_deadline(deadline, task));
+    };
+
+    const auto now = std::chrono::steady_clock::now();
+    addTask(4, std::chrono::steady_clock::time_point::max());
+    addTask(3, now + std::chrono::hours(3));
+    addTask(1, now + std::chrono::hours(1));
+    addTask(2, now + std::chrono::hours(2));
+    addTask(5, std::chrono::steady_clock::time_point::max());
+    addTask(0, now + std::chrono::minutes(1));
+
+    continueExecution->RaiseAll();
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(order, std::vector<int>({ 0, 1, 2, 3, 4, 5 }));
+}
+
+TEST(thread_pool_test, earliest_deadline_first_many_tasks)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .earliestDeadlineFirst = true });
+
+    const auto continueExecution = block_worker(threadPool);
+
+    // deadlines repeat, tasks with the same deadline keep the adding order
+    constexpr int kTasksCount = 1000;
+    constexpr int kDeadlinesCount = 37;
+    const auto now = std::chrono::steady_clock::now();
+    const auto getDeadline = [&](int task) { return now + std::chrono::minutes(1 + task * 17 % kDeadlinesCount); };
+
+    std::vector<int> order;
+    std::vector<ext::thread_pool::TaskId> taskIds;
+    for (int task = 0; task < kTasksCount; ++task)
+    {
+        taskIds.emplace_back(threadPool.add_task_with_deadline(getDeadline(task), [&order, task]()
+        {
+            order.push_back(task);
+        }).first);
+    }
+    // removed tasks leave the deadline order
+    for (int task = 0; task < kTasksCount; task += 3)
+    {
+        EXPECT_TRUE(threadPool.stop_and_remove_task(taskIds[task]));
+    }
+
+    continueExecution->RaiseAll();
+    threadPool.wait_for_tasks();
+
+    std::vector<int> expectedOrder;
+    for (int task = 0; task < kTasksCount; ++task)
+    {
+        if (task % 3 != 0)
+            expectedOrder.push_back(task);
+    }
+    std::stable_sort(expectedOrder.begin(), expectedOrder.end(),
+                     [&](int first, int second) { return getDeadline(first) < getDeadline(second); });
+    EXPECT_EQ(order, expectedOrder);
+}
+
+TEST(thread_pool_test, fair_share_queues)
+{
+    ext::thread_pool threadPool(1);
+
+    const auto floodingQueue = threadPool.add_queue("flooding");
+    const auto weightedQueue = threadPool.add_queue("weighted", 2);
+    EXPECT_THROW(threadPool.add_queue("zero weight", 0), ext::check::CheckFailedException);
+
+    const auto continueExecution = block_worker(threadPool);
+
+    std::mutex orderMutex;
+    std::string order;
+    const auto task = [&](char queue)
+    {
+        std::lock_guard lock(orderMutex);
+        order.push_back(queue);
+    };
+
+    // flooding tenant adds its tasks first but doesn't delay other tenants
+    for (int i = 0; i < 6; ++i)
+    {
+        EXT_IGNORE_RESULT(threadPool.add_task_to_queue(floodingQueue, task, 'f'));
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        EXT_IGNORE_RESULT(threadPool.add_task_to_queue(weightedQueue, task, 'w'));
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        EXT_IGNORE_RESULT(threadPool.add_task(task, 'c'));
+    }
+    EXPECT_EQ(threadPool.get_queue_stats(floodingQueue).queuedTasksCount, 6u);
+
+    continueExecution->RaiseAll();
+    threadPool.wait_for_tasks();
+
+    // each round executes 1 flooding task, 2 weighted tasks and 1 common task
+    EXPECT_EQ(order, "fwwcfwwcffff");
+
+    const auto floodingStats = threadPool.get_queue_stats(floodingQueue);
+    EXPECT_EQ(floodingStats.name, "flooding");
+    EXPECT_EQ(floodingStats.weight, 1u);
+    EXPECT_EQ(floodingStats.queuedTasksCount, 0u);
+    EXPECT_EQ(floodingStats.startedTasksCount, 6u);
+    EXPECT_EQ(floodingStats.queueWaitTime.count(), 6u);
+    EXPECT_EQ(threadPool.get_queue_stats(weightedQueue).startedTasksCount, 4u);
+    EXPECT_THROW(EXT_IGNORE_RESULT(threadPool.get_queue_stats(10)), ext::check::CheckFailedException);
+}
+
+TEST(thread_pool_test, fair_share_queues_removing)
+{
+    ext::thread_pool threadPool(1);
+    const auto queue = threadPool.add_queue("queue");
+
+    const auto continueExecution = block_worker(threadPool);
+
+    std::atomic_int executedTasksCount = 0;
+    auto removedTask = threadPool.add_task_to_queue(queue, [&]() { ++executedTasksCount; });
+    EXT_IGNORE_RESULT(threadPool.add_task_to_queue(queue, [&]() { ++executedTasksCount; }));
+    EXPECT_TRUE(threadPool.stop_and_remove_task(removedTask.first));
+    EXPECT_EQ(threadPool.get_queue_stats(queue).queuedTasksCount, 1u);
+
+    continueExecution->RaiseAll();
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(executedTasksCount, 1);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        EXT_IGNORE_RESULT(threadPool.add_task_to_queue(queue, [&]() { ++executedTasksCount; }));
+    }
+    threadPool.interrupt_and_remove_all_tasks();
+    EXPECT_EQ(threadPool.get_queue_stats(queue).queuedTasksCount, 0u);
+}
+
+TEST(thread_pool_test, bounded_queue_reject)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{
+        .threadsCount = 1, .queueCapacity = 2, .overflowPolicy = ext::thread_pool::OverflowPolicy::eReject });
+    const auto continueExecution = block_worker(threadPool);
+
+    auto first = threadPool.try_add_task([]() { return 1; });
+    ASSERT_TRUE(first.has_value());
+    auto second = threadPool.add_task([]() { return 2; });
+    EXPECT_FALSE(threadPool.try_add_task([]() { return 3; }).has_value());
+    EXPECT_THROW(threadPool.add_task([]() { return 4; }), ext::thread_pool::queue_overflow);
+    EXPECT_THROW(threadPool.add_tasks(std::vector<int>(1), [](int) {}), ext::thread_pool::queue_overflow);
+
+    continueExecution->RaiseAll();
+    EXPECT_EQ(first->second.get(), 1);
+    EXPECT_EQ(second.second.get(), 2);
+    threadPool.wait_for_tasks();
+
+    // places are released after tasks execution
+    EXPECT_TRUE(threadPool.try_add_task([]() { return 5; }).has_value());
+    threadPool.wait_for_tasks();
+}
+
+TEST(thread_pool_test, bounded_queue_block)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .queueCapacity = 1 });
+    const auto continueExecution = block_worker(threadPool);
+
+    std::atomic_int executedTasksCount = 0;
+    threadPool.add_task_detached([&]() { ++executedTasksCount; });
+
+    std::atomic_bool taskAdded = false;
+    std::thread submitter([&]()
+    {
+        threadPool.add_task_detached([&]() { ++executedTasksCount; });
+        taskAdded = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(taskAdded);
+
+    continueExecution->RaiseAll();
+    submitter.join();
+    EXPECT_TRUE(taskAdded);
+    threadPool.wait_for_tasks();
+    EXPECT_EQ(executedTasksCount, 2);
+}
+
+TEST(thread_pool_test, bounded_queue_caller_runs)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{
+        .threadsCount = 1, .queueCapacity = 1, .overflowPolicy = ext::thread_pool::OverflowPolicy::eCallerRuns });
+    const auto continueExecution = block_worker(threadPool);
+
+    EXT_IGNORE_RESULT(threadPool.add_task([]() {}));
+    auto callerTask = threadPool.add_task([]() { return std::this_thread::get_id(); });
+    EXPECT_EQ(callerTask.second.get(), std::this_thread::get_id());
+    EXPECT_FALSE(threadPool.stop_and_remove_task(callerTask.first));
+
+    std::atomic_int executedTasksCount = 0;
+    threadPool.add_tasks(std::vector<int>(3), [&](int) { ++executedTasksCount; }).wait();
+    EXPECT_EQ(executedTasksCount, 3);
+
+    continueExecution->RaiseAll();
+    threadPool.wait_for_tasks();
+}
+
+TEST(thread_pool_test, bounded_queue_drop_oldest)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{
+        .threadsCount = 1, .queueCapacity = 2, .overflowPolicy = ext::thread_pool::OverflowPolicy::eDropOldest });
+    const auto continueExecution = block_worker(threadPool);
+
+    auto oldest = threadPool.add_task([]() { return 1; });
+    auto second = threadPool.add_task([]() { return 2; });
+    auto newest = threadPool.add_task([]() { return 3; });
+
+    continueExecution->RaiseAll();
+    EXPECT_THROW(oldest.second.get(), std::future_error);
+    EXPECT_EQ(second.second.get(), 2);
+    EXPECT_EQ(newest.second.get(), 3);
+    threadPool.wait_for_tasks();
+}
+
+TEST(thread_pool_test, bounded_queue_caller_runs_deadline_and_metrics)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .collectMetrics = true,
+        .queueCapacity = 1, .overflowPolicy = ext::thread_pool::OverflowPolicy::eCallerRuns });
+    const auto continueExecution = block_worker(threadPool);
+    threadPool.add_task_detached([]() {});
+
+    bool expiredTaskExecuted = false;
+    auto expiredTask = threadPool.add_task_with_deadline(
+        std::chrono::steady_clock::now() - std::chrono::milliseconds(1), [&]() { expiredTaskExecuted = true; });
+    EXPECT_THROW(expiredTask.second.get(), ext::thread_pool::deadline_exceeded);
+    EXPECT_FALSE(expiredTaskExecuted);
+    EXPECT_EQ(threadPool.add_task([]() { return 10; }).second.get(), 10);
+
+    continueExecution->RaiseAll();
+    threadPool.wait_for_tasks();
+    const auto metrics = threadPool.get_metrics();
+    EXPECT_EQ(metrics.total.expiredTasksCount, 1u);
+    EXPECT_EQ(metrics.total.completedTasksCount, 3u);
+    EXPECT_EQ(metrics.total.queueWaitTime.count(), 4u);
+    EXPECT_EQ(metrics.total.executionTime.count(), 3u);
+}
+
+TEST(thread_pool_test, bounded_queue_drop_oldest_of_all_priorities)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{
+        .threadsCount = 1, .queueCapacity = 2, .overflowPolicy = ext::thread_pool::OverflowPolicy::eDropOldest });
+    const auto continueExecution = block_worker(threadPool);
+
+    auto oldest = threadPool.add_high_priority_task([]() { return 1; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    auto second = threadPool.add_task([]() { return 2; });
+    auto newest = threadPool.add_task([]() { return 3; });
+
+    continueExecution->RaiseAll();
+    EXPECT_THROW(oldest.second.get(), std::future_error);
+    EXPECT_EQ(second.second.get(), 2);
+    EXPECT_EQ(newest.second.get(), 3);
+    threadPool.wait_for_tasks();
+}
+
+namespace {
+
+// recursive fibonacci calculation, each task waits for its subtasks
+std::uint64_t fibonacci(ext::thread_pool& threadPool, unsigned number)
+{
+    if (number < 2)
+        return number;
+
+    auto first = threadPool.add_task(fibonacci, std::ref(threadPool), number - 1);
+    auto second = threadPool.add_task(fibonacci, std::ref(threadPool), number - 2);
+    threadPool.wait(first.second);
+    threadPool.wait(second.second);
+    return first.second.get() + second.second.get();
+}
+
+} // namespace
+
+TEST(thread_pool_test, wait_helping_in_workers)
+{
+    // all workers wait for subtasks, without helping the pool deadlocks
+    for (const bool workStealing : { false, true })
+    {
+        ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2, .workStealing = workStealing });
+        auto result = threadPool.add_task(fibonacci, std::ref(threadPool), 15u);
+        threadPool.wait(result.second);
+        EXPECT_EQ(result.second.get(), 610u);
+    }
+
+    ext::thread_pool threadPool(1);
+    std::promise<void> promise;
+    const std::shared_future<void> future = promise.get_future().share();
+    auto waitingTask = threadPool.add_task([&]() { threadPool.wait(future); });
+
+    // waiting task executes other tasks while the future is not ready
+    EXPECT_EQ(threadPool.add_task([]() { return 1; }).second.get(), 1);
+    EXPECT_EQ(waitingTask.second.wait_for(std::chrono::milliseconds(10)), std::future_status::timeout);
+    promise.set_value();
+    waitingTask.second.get();
+}
+
+TEST(thread_pool_test, blocking_region_compensation)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1, .maxCompensatingThreadsCount = 1 });
+
+    ext::Event regionEntered, continueExecution;
+    auto blockingTask = threadPool.add_task([&]()
+    {
+        ext::blocking_region blocking;
+        {
+            // nested region doesn't start one more thread
+            ext::blocking_region nestedBlocking;
+            regionEntered.RaiseAll();
+            continueExecution.Wait();
+        }
+    });
+    ASSERT_TRUE(regionEntered.Wait(std::chrono::seconds(1)));
+
+    // compensating worker executes tasks while the only worker is blocked
+    EXPECT_EQ(threadPool.add_task([]() { return 1; }).second.get(), 1);
+    auto counters = threadPool.get_threads_counters();
+    EXPECT_EQ(counters.threadsCount, 2u);
+    EXPECT_EQ(counters.blockedThreadsCount, 1u);
+    EXPECT_EQ(counters.compensatingThreadsCount, 1u);
+
+    continueExecution.RaiseAll();
+    blockingTask.second.get();
+
+    // compensating worker retires after the region end
+    EXPECT_TRUE(wait_for_condition([&]() { return threadPool.threads_count() == 1; }));
+    counters = threadPool.get_threads_counters();
+    EXPECT_EQ(counters.blockedThreadsCount, 0u);
+    EXPECT_EQ(counters.compensatingThreadsCount, 0u);
+    EXPECT_EQ(counters.retiredThreadsCount, 1u);
+
+    // blocking region outside of the pool does nothing
+    ext::blocking_region blocking;
+    EXPECT_EQ(threadPool.add_task([]() { return 2; }).second.get(), 2);
+}
+
+TEST(thread_pool_test, blocking_region_compensation_keeps_workers_placement)
+{
+    // worker slot index defines the worker cpu and NUMA node, slots are visible in the thread names
+    const unsigned allowedCpu = test::cpu::get_allowed_cpu();
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2, .threadsName = "ext_pool",
+                                                           .workersCpus = { allowedCpu, allowedCpu },
+                                                           .maxCompensatingThreadsCount = 1 });
+
+    for (int cycle = 0; cycle < 3; ++cycle)
+    {
+        SCOPED_TRACE(cycle);
+
+        ext::Event regionEntered, continueExecution;
+        auto blockingTask = threadPool.add_task([&]()
+        {
+            ext::blocking_region blocking;
+            regionEntered.RaiseAll();
+            continueExecution.Wait();
+        });
+        ASSERT_TRUE(regionEntered.Wait(std::chrono::seconds(1)));
+        EXPECT_EQ(threadPool.get_threads_counters().compensatingThreadsCount, 1u);
+
+        // unblocked worker continues to work, compensating one retires
+        continueExecution.RaiseAll();
+        blockingTask.second.get();
+        ASSERT_TRUE(wait_for_condition([&]() { return threadPool.get_threads_counters().compensatingThreadsCount == 0; }));
+        EXPECT_EQ(threadPool.threads_count(), 2u);
+
+#ifdef __linux__
+        // each task waits for the other one, so they are executed by different workers
+        std::mutex namesMutex;
+        std::set<std::string> names;
+        std::atomic_uint startedTasks = 0;
+        for (int i = 0; i < 2; ++i)
+        {
+            threadPool.add_task_detached([&]()
+            {
+                ++startedTasks;
+                EXPECT_TRUE(wait_for_condition([&]() { return startedTasks == 2; }));
+
+                char name[16] = {};
+                pthread_getname_np(pthread_self(), name, sizeof(name));
+                std::lock_guard lock(namesMutex);
+                names.emplace(name);
+            });
+        }
+        threadPool.wait_for_tasks();
+        EXPECT_EQ(names, std::set<std::string>({ "ext_pool0", "ext_pool1" }));
+#endif
+    }
+}
+
+TEST(thread_pool_test, blocking_region_without_free_slots)
+{
+    ext::thread_pool threadPool(2);
+
+    ext::Event regionEntered, continueExecution;
+    auto blockingTask = threadPool.add_task([&]()
+    {
+        ext::blocking_region blocking;
+        regionEntered.RaiseAll();
+        continueExecution.Wait();
+    });
+    ASSERT_TRUE(regionEntered.Wait(std::chrono::seconds(1)));
+
+    EXPECT_EQ(threadPool.add_task([]() { return 1; }).second.get(), 1);
+    const auto counters = threadPool.get_threads_counters();
+    EXPECT_EQ(counters.threadsCount, 2u);
+    EXPECT_EQ(counters.compensatingThreadsCount, 0u);
+    EXPECT_EQ(counters.maxThreadsReachedCount, 1u);
+
+    continueExecution.RaiseAll();
+    blockingTask.second.get();
+}
+
+TEST(thread_pool_test, hung_task_watchdog)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 2,
+                                                           .hungTaskTimeout = std::chrono::milliseconds(10) });
+
+    // long task is reported once and finishes normally
+    threadPool.add_task([]() { std::this_thread::sleep_for(std::chrono::milliseconds(100)); }).second.get();
+    EXPECT_EQ(threadPool.get_metrics().hungTasksCount, 1u);
+
+    threadPool.add_task([]() {}).second.get();
+    EXPECT_EQ(threadPool.get_metrics().hungTasksCount, 1u);
+}
+
+TEST(thread_pool_test, hung_task_watchdog_interruption)
+{
+    ext::thread_pool threadPool(ext::thread_pool::Options{ .threadsCount = 1,
+                                                           .hungTaskTimeout = std::chrono::milliseconds(10),
+                                                           .interruptHungTasks = true });
+
+    auto hungTask = threadPool.add_task([]() { ext::this_thread::interruptible_sleep_for(std::chrono::minutes(1)); });
+    EXPECT_THROW(hungTask.second.get(), ext::thread::thread_interrupted);
+    EXPECT_EQ(threadPool.get_metrics().hungTasksCount, 1u);
+
+    // worker thread is restored after the interruption
+    EXPECT_EQ(threadPool.add_task([]() { ext::this_thread::interruptible_sleep_for(std::chrono::milliseconds(1)); return 1; })
+        .second.get(), 1);
+}
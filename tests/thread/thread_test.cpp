@@ -1,5 +1,7 @@
 #include "gtest/gtest.h"
 
+#include "cpu_helper.h"
+
 #include <ext/thread/event.h>
 #include <ext/thread/thread.h>
 #include <ext/thread/stop_token.h>
@@ -344,3 +346,81 @@ TEST(thread_test, interruptible_sleep_for_1_millisecond_in_thread)
     myThread.join();
     ASSERT_LE(delta.count(), 3);
 }
+
+TEST(thread_test, thread_settings)
+{
+    ext::Event continueExecution;
+    ext::thread thread([&]()
+    {
+        continueExecution.Wait();
+    });
+
+    EXPECT_TRUE(thread.set_name("ext_test_thread"));
+    EXPECT_TRUE(thread.set_affinity({ test::cpu::get_allowed_cpu() }));
+    EXPECT_FALSE(thread.set_affinity({}));
+    EXPECT_TRUE(thread.set_scheduling_policy(ext::thread::SchedulingPolicy::eNormal));
+#ifdef __linux__
+    char name[16] = {};
+    ASSERT_EQ(pthread_getname_np(thread.native_handle(), name, sizeof(name)), 0);
+    EXPECT_STREQ(name, "ext_test_thread");
+#endif
+
+    continueExecution.RaiseAll();
+    thread.join();
+    EXPECT_FALSE(thread.set_name("finished"));
+}
+
+TEST(thread_test, this_thread_settings)
+{
+    const int allowedCpu = int(test::cpu::get_allowed_cpu());
+    std::atomic_bool affinitySet = false;
+    std::atomic_int executingCpu = -1;
+    ext::thread thread([&]()
+    {
+        affinitySet = ext::this_thread::set_affinity({ unsigned(allowedCpu) });
+        EXT_UNUSED(ext::this_thread::set_name("ext_this_thread"));
+#ifdef __linux__
+        executingCpu = sched_getcpu();
+#else
+        executingCpu = allowedCpu;
+#endif
+    });
+    thread.join();
+
+    EXPECT_TRUE(affinitySet);
+    EXPECT_EQ(executingCpu, allowedCpu);
+}
+
+TEST(thread_test, parse_cpu_list)
+{
+    EXPECT_EQ(ext::thread_details::parse_cpu_list("0-3,8,10-11\n"), std::vector<unsigned>({ 0, 1, 2, 3, 8, 10, 11 }));
+    EXPECT_EQ(ext::thread_details::parse_cpu_list("5"), std::vector<unsigned>({ 5 }));
+    EXPECT_TRUE(ext::thread_details::parse_cpu_list("").empty());
+    EXPECT_EQ(ext::thread_details::parse_cpu_list("3-1,x,2"), std::vector<unsigned>({ 2 }));
+
+    const auto nodes = ext::thread_details::get_numa_nodes_cpus();
+    ASSERT_FALSE(nodes.empty());
+    EXPECT_FALSE(nodes.front().empty());
+}
+
+TEST(thread_test, available_concurrency)
+{
+    EXPECT_EQ(ext::thread_details::parse_cgroup_cpu_max("400000 100000\n"), 4.0);
+    EXPECT_EQ(ext::thread_details::parse_cgroup_cpu_max("50000 100000"), 0.5);
+    EXPECT_FALSE(ext::thread_details::parse_cgroup_cpu_max("max 100000\n").has_value());
+    EXPECT_FALSE(ext::thread_details::parse_cgroup_cpu_max("").has_value());
+    EXPECT_EQ(ext::thread_details::get_cgroup_cpu_limit(150000, 100000), 1.5);
+    // cgroup v1 quota without limit
+    EXPECT_FALSE(ext::thread_details::get_cgroup_cpu_limit(-1, 100000).has_value());
+
+    const unsigned concurrency = ext::available_concurrency();
+    EXPECT_GE(concurrency, 1u);
+    if (std::thread::hardware_concurrency() != 0)
+    {
+        EXPECT_LE(concurrency, std::thread::hardware_concurrency());
+    }
+    if (const auto affinityCpus = ext::thread_details::get_process_affinity_cpus_count(); affinityCpus != 0)
+    {
+        EXPECT_LE(concurrency, affinityCpus);
+    }
+}